@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <limits>
+#include "binary_format.h"
+
+const char BinaryFormat::magic[8] = {'C', 'G', 'E', 'O', 'B', 'I', 'N', '\0'};
+const uint32_t BinaryFormat::version = 1;
+const std::size_t BinaryFormat::columnAlignment = 64;
+
+bool BinaryFormat::isBinary( char const *data, std::size_t size )
+{
+    return size >= sizeof(Header) && std::memcmp(data, magic, sizeof(magic)) == 0;
+}
+
+BinaryFormat::Header BinaryFormat::makeHeader( Type type, Scalar scalar, uint64_t count )
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.type = type;
+    header.scalar = scalar;
+    header.count = count;
+
+    const double inf = std::numeric_limits<double>::infinity();
+    header.bbox[0] = header.bbox[1] = inf;
+    header.bbox[2] = header.bbox[3] = -inf;
+    return header;
+}
+
+int BinaryFormat::columnCount( Type type )
+{
+    return type == Type::POINTS ? 3 : 5;
+}
+
+std::size_t BinaryFormat::scalarSize( Scalar scalar )
+{
+    switch (scalar)
+    {
+    case Scalar::FLOAT32:
+    case Scalar::INT32:
+        return 4;
+    case Scalar::FLOAT64:
+    case Scalar::INT64:
+        return 8;
+    }
+    return 0;
+}
+
+std::size_t BinaryFormat::align( std::size_t offset )
+{
+    return (offset + columnAlignment - 1) / columnAlignment * columnAlignment;
+}
+
+std::size_t BinaryFormat::columnSize( Header const &header, int column )
+{
+    if (column == 0)
+        return sizeof(int32_t);
+    return column < columnCount(header.type) ? scalarSize(header.scalar) : sizeof(double);
+}
+
+std::size_t BinaryFormat::columnOffset( Header const &header, int column )
+{
+    std::size_t
+            count = static_cast<std::size_t>(header.count),
+            offset = align(sizeof(Header));
+    for (int c = 0; c < column; c++)
+        offset = align(offset + count * columnSize(header, c));
+    return offset;
+}
+
+std::size_t BinaryFormat::fileSize( Header const &header )
+{
+    int last = columnCount(header.type) - 1 + ((header.flags & WEIGHTED) != 0);
+    return columnOffset(header, last) +
+            static_cast<std::size_t>(header.count) * columnSize(header, last);
+}
+
+bool BinaryFormat::fits( Header const &header, std::size_t size )
+{
+    if (scalarSize(header.scalar) == 0)
+        return false;
+    int columns = columnCount(header.type) + ((header.flags & WEIGHTED) != 0);
+    for (int c = 0; c < columns; c++)
+        if (header.count > size / columnSize(header, c))
+            return false;
+    return fileSize(header) <= size;
+}
+
+BinaryFormat::Writer::Writer( std::ostream &os ) : os(&os), _written(0) {}
+
+void BinaryFormat::Writer::put( void const *data, std::size_t offset, std::size_t bytes )
+{
+    static const char zeros[64] = {0};
+    while (_written < offset)
+    {
+        std::size_t pad = std::min(offset - _written, sizeof(zeros));
+        os->write(zeros, static_cast<std::streamsize>(pad));
+        _written += pad;
+    }
+    os->write(static_cast<char const *>(data), static_cast<std::streamsize>(bytes));
+    _written += bytes;
+}
+
+std::size_t BinaryFormat::Writer::written() const
+{
+    return _written;
+}
@@ -0,0 +1,208 @@
+#ifndef BINARY_FORMAT_H
+#define BINARY_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+/*!
+ * \brief The BinaryFormat struct
+ * \details Columnar file layout shared by point and segment files:
+ * \details 64 byte header followed by columns, every column starting at
+ * \details a multiple of columnAlignment bytes from the beginning of file.
+ * \details Points: id, x, y and weight if WEIGHTED flag is set.
+ * \details Segments: id, x0, y0, x1, y1.
+ * \details Segment index: segment columns followed by index arrays (see
+ * \details SegmentIndex::save).
+ * \details Ids are int32, coordinates have header scalar type, weights
+ * \details are float64.
+ * \details Values are stored in native (little endian) byte order.
+ */
+struct BinaryFormat
+{
+    enum class Type : uint32_t
+    {
+        POINTS = 1,
+        SEGMENTS = 2,
+        SEGMENT_INDEX = 3
+    };
+
+    enum class Scalar : uint32_t
+    {
+        FLOAT32 = 1,
+        FLOAT64 = 2,
+        INT32 = 3,
+        INT64 = 4
+    };
+
+    enum Flags : uint32_t
+    {
+        //! Weight column follows coordinate ones
+        WEIGHTED = 1
+    };
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        Type type;
+        Scalar scalar;
+        uint32_t flags;
+        uint64_t count;
+        //! Bounding box: min x, min y, max x, max y
+        double bbox[4];
+    };
+
+    static const char magic[8];
+    static const uint32_t version;
+    static const std::size_t columnAlignment;
+
+    /*!
+     * \brief Check file signature function.
+     * \param data File contents.
+     * \param size File size.
+     * \return true if file starts with binary header, false otherwise.
+     */
+    static bool isBinary( char const *data, std::size_t size );
+
+    /*!
+     * \brief Make header function.
+     * \param type File type.
+     * \param scalar Coordinate type.
+     * \param count Number of records.
+     * \return Header with empty bounding box.
+     */
+    static Header makeHeader( Type type, Scalar scalar, uint64_t count );
+
+    /*!
+     * \brief Get number of columns function.
+     * \param type File type.
+     * \return Number of columns including id one.
+     */
+    static int columnCount( Type type );
+
+    /*!
+     * \brief Get scalar size function.
+     * \param scalar Coordinate type.
+     * \return Size in bytes, 0 for unknown type.
+     */
+    static std::size_t scalarSize( Scalar scalar );
+
+    /*!
+     * \brief Align offset function.
+     * \param offset Offset from beginning of file in bytes.
+     * \return Least multiple of columnAlignment not less than offset.
+     */
+    static std::size_t align( std::size_t offset );
+
+    /*!
+     * \brief Get column value size function.
+     * \param header File header.
+     * \param column Column number, 0 is id column.
+     * \return Size in bytes.
+     */
+    static std::size_t columnSize( Header const &header, int column );
+
+    /*!
+     * \brief Get column offset function.
+     * \param header File header.
+     * \param column Column number, 0 is id column.
+     * \return Offset from beginning of file in bytes.
+     */
+    static std::size_t columnOffset( Header const &header, int column );
+
+    /*!
+     * \brief Get expected file size function.
+     * \param header File header.
+     * \return Size in bytes.
+     */
+    static std::size_t fileSize( Header const &header );
+
+    /*!
+     * \brief Check columns fit in file function.
+     * \details Record count is checked against file size column by column
+     * \details before offsets are computed, so corrupt counts can not wrap.
+     * \param header File header.
+     * \param size File size.
+     * \return true if all columns lie within file, false otherwise.
+     */
+    static bool fits( Header const &header, std::size_t size );
+
+    /*!
+     * \brief Read coordinate column function.
+     * \param src Column start.
+     * \param scalar Stored coordinate type.
+     * \param dst[OUT] Destination array.
+     * \param count Number of values.
+     */
+    template<class T>
+    static void readColumn( void const *src, Scalar scalar, T *dst, std::size_t count )
+    {
+        switch (scalar)
+        {
+        case Scalar::FLOAT32:
+            convert(static_cast<float const *>(src), dst, count);
+            break;
+        case Scalar::FLOAT64:
+            convert(static_cast<double const *>(src), dst, count);
+            break;
+        case Scalar::INT32:
+            convert(static_cast<int32_t const *>(src), dst, count);
+            break;
+        case Scalar::INT64:
+            convert(static_cast<int64_t const *>(src), dst, count);
+            break;
+        }
+    }
+
+    /*!
+     * \brief The Writer class
+     * \details Writes blocks at given offsets from beginning of file in
+     * \details increasing order, gaps are filled with zeros.
+     */
+    class Writer
+    {
+    public:
+        /*!
+         * \brief Class constructor.
+         * \param os Output stream at beginning of file.
+         */
+        explicit Writer( std::ostream &os );
+
+        /*!
+         * \brief Write block function.
+         * \param data Block.
+         * \param offset Offset from beginning of file, not less than written().
+         * \param bytes Block size in bytes.
+         */
+        void put( void const *data, std::size_t offset, std::size_t bytes );
+
+        /*!
+         * \brief Get number of bytes written function.
+         */
+        std::size_t written() const;
+
+    private:
+        std::ostream *os;
+        std::size_t _written;
+    };
+
+private:
+    template<class S, class T>
+    static void convert( S const *src, T *dst, std::size_t count )
+    {
+        for (std::size_t i = 0; i < count; i++)
+            dst[i] = static_cast<T>(src[i]);
+    }
+
+    template<class T>
+    static void convert( T const *src, T *dst, std::size_t count )
+    {
+        std::memcpy(dst, src, count * sizeof(T));
+    }
+};
+
+static_assert(sizeof(BinaryFormat::Header) == 64, "binary header must be 64 bytes");
+
+#endif // BINARY_FORMAT_H
@@ -0,0 +1,86 @@
+#include <fstream>
+#include "mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#define HAVE_MMAP
+#endif
+
+MappedFile::MappedFile() : _data(nullptr), _size(0), mapped(false) {}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+bool MappedFile::open( std::string const &fileName )
+{
+    close();
+
+#ifdef HAVE_MMAP
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    _size = static_cast<std::size_t>(st.st_size);
+    if (_size > 0)
+    {
+        void *addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            madvise(addr, _size, MADV_SEQUENTIAL);
+            _data = static_cast<char const *>(addr);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+
+    if (_size == 0 || mapped)
+        return true;
+#endif
+
+    // no mmap: read whole file
+    std::ifstream ifs(fileName, std::ios::binary | std::ios::ate);
+    if (!ifs)
+        return false;
+    _size = static_cast<std::size_t>(ifs.tellg());
+    buffer.resize(_size);
+    ifs.seekg(0);
+    if (_size > 0 && !ifs.read(buffer.data(), static_cast<std::streamsize>(_size)))
+        return false;
+    _data = buffer.data();
+    return true;
+}
+
+void MappedFile::close()
+{
+#ifdef HAVE_MMAP
+    if (mapped)
+        munmap(const_cast<char *>(_data), _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    mapped = false;
+    buffer.clear();
+    buffer.shrink_to_fit();
+}
+
+char const * MappedFile::data() const
+{
+    return _data;
+}
+
+std::size_t MappedFile::size() const
+{
+    return _size;
+}
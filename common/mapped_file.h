@@ -0,0 +1,61 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*!
+ * \brief The MappedFile class
+ * \details Read-only view of whole file contents. Memory mapped on POSIX
+ * \details systems, read into a buffer elsewhere.
+ */
+class MappedFile
+{
+public:
+    /*!
+     * \brief Default class constructor.
+     */
+    MappedFile();
+
+    /*!
+     * \brief Class destructor. Unmaps file.
+     */
+    ~MappedFile();
+
+    MappedFile( MappedFile const & ) = delete;
+    MappedFile & operator=( MappedFile const & ) = delete;
+
+    /*!
+     * \brief Open file function.
+     * \param fileName File name to map.
+     * \return true if ok, false otherwise.
+     */
+    bool open( std::string const &fileName );
+
+    /*!
+     * \brief Unmap file function.
+     */
+    void close();
+
+    /*!
+     * \brief Get file contents function.
+     * \return Pointer to first byte of file.
+     */
+    char const * data() const;
+
+    /*!
+     * \brief Get file size function.
+     * \return File size in bytes.
+     */
+    std::size_t size() const;
+
+private:
+    char const *_data;
+    std::size_t _size;
+    bool mapped;
+    //! Fallback storage when mapping is not available
+    std::vector<char> buffer;
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,256 @@
+#include <cmath>
+#include <limits>
+#include "predicates.h"
+
+namespace
+{
+const double epsilon = std::numeric_limits<double>::epsilon() / 2;
+// error bound of orient2d double evaluation, Shewchuk's ccwerrboundA
+const double orientErrorBound = (3.0 + 16.0 * epsilon) * epsilon;
+
+inline void twoSum( double a, double b, double &x, double &y )
+{
+    x = a + b;
+    double bv = x - a, av = x - bv;
+    y = (a - av) + (b - bv);
+}
+
+inline void fastTwoSum( double a, double b, double &x, double &y )
+{
+    x = a + b;
+    y = b - (x - a);
+}
+
+inline void twoProduct( double a, double b, double &x, double &y )
+{
+    x = a * b;
+    y = std::fma(a, b, -x);
+}
+
+//! Sum of a and b is x without rounding
+inline bool exactSum( double a, double b, double x )
+{
+    double sum, roundoff;
+    twoSum(a, b, sum, roundoff);
+    return roundoff == 0 && std::isfinite(x);
+}
+
+//! Product of a and b is x without rounding, underflow is not exact
+inline bool exactProduct( double a, double b, double x )
+{
+    if (!std::isfinite(x))
+        return false;
+    if (x == 0)
+        return a == 0 || b == 0;
+    return std::fabs(x) >= std::numeric_limits<double>::min() && std::fma(a, b, -x) == 0;
+}
+}
+
+Expansion::Expansion( double value )
+{
+    if (value != 0)
+        terms.push_back(value);
+}
+
+void Expansion::grow( double value )
+{
+    // Shewchuk's GROW-EXPANSION with zero elimination
+    std::size_t out = 0;
+    double q = value;
+    for (std::size_t i = 0; i < terms.size(); i++)
+    {
+        double h;
+        twoSum(q, terms[i], q, h);
+        if (h != 0)
+            terms[out++] = h;
+    }
+    terms.resize(out);
+    if (q != 0)
+        terms.push_back(q);
+}
+
+Expansion Expansion::scale( double value ) const
+{
+    // Shewchuk's SCALE-EXPANSION with zero elimination
+    Expansion result;
+    if (terms.empty() || value == 0)
+        return result;
+
+    double q, h;
+    twoProduct(terms[0], value, q, h);
+    if (h != 0)
+        result.terms.push_back(h);
+    for (std::size_t i = 1; i < terms.size(); i++)
+    {
+        double p1, p0, sum;
+        twoProduct(terms[i], value, p1, p0);
+        twoSum(q, p0, sum, h);
+        if (h != 0)
+            result.terms.push_back(h);
+        fastTwoSum(p1, sum, q, h);
+        if (h != 0)
+            result.terms.push_back(h);
+    }
+    if (q != 0)
+        result.terms.push_back(q);
+    return result;
+}
+
+Expansion Expansion::operator+( Expansion const &rhs ) const
+{
+    Expansion result = terms.size() >= rhs.terms.size() ? *this : rhs;
+    auto &other = terms.size() >= rhs.terms.size() ? rhs : *this;
+    for (double t : other.terms)
+        result.grow(t);
+    return result;
+}
+
+Expansion Expansion::operator-( Expansion const &rhs ) const
+{
+    return *this + (-rhs);
+}
+
+Expansion Expansion::operator*( Expansion const &rhs ) const
+{
+    Expansion result;
+    for (double t : rhs.terms)
+        result = result + scale(t);
+    return result;
+}
+
+Expansion Expansion::operator-() const
+{
+    Expansion result = *this;
+    for (auto &t : result.terms)
+        t = -t;
+    return result;
+}
+
+int Expansion::sign() const
+{
+    if (terms.empty())
+        return 0;
+    return terms.back() > 0 ? 1 : -1;
+}
+
+double Expansion::estimate() const
+{
+    double sum = 0;
+    for (double t : terms)
+        sum += t;
+    return sum;
+}
+
+/*
+ * Every rounding adds at most epsilon * |result| plus half of the smallest
+ * subnormal; bounds are doubled to cover rounding of bounds themselves.
+ */
+static inline double roundingError( double value )
+{
+    return 2 * (epsilon * std::fabs(value) + std::numeric_limits<double>::denorm_min());
+}
+
+FilteredDouble::FilteredDouble( double value ) : value(value), error(0) {}
+
+FilteredDouble::FilteredDouble( double value, double error ) : value(value), error(error) {}
+
+FilteredDouble FilteredDouble::operator+( FilteredDouble const &rhs ) const
+{
+    // exact operands stay exact while nothing is rounded: integer and short
+    // float coordinates give certain zero signs without Expansion
+    double sum = value + rhs.value;
+    if (error == 0 && rhs.error == 0 && exactSum(value, rhs.value, sum))
+        return FilteredDouble(sum, 0);
+    return FilteredDouble(sum, error + rhs.error + roundingError(sum));
+}
+
+FilteredDouble FilteredDouble::operator-( FilteredDouble const &rhs ) const
+{
+    double diff = value - rhs.value;
+    if (error == 0 && rhs.error == 0 && exactSum(value, -rhs.value, diff))
+        return FilteredDouble(diff, 0);
+    return FilteredDouble(diff, error + rhs.error + roundingError(diff));
+}
+
+FilteredDouble FilteredDouble::operator*( FilteredDouble const &rhs ) const
+{
+    double product = value * rhs.value;
+    if (error == 0 && rhs.error == 0 && exactProduct(value, rhs.value, product))
+        return FilteredDouble(product, 0);
+    double bound = std::fabs(value) * rhs.error + std::fabs(rhs.value) * error + error * rhs.error;
+    return FilteredDouble(product, bound * (1 + 4 * epsilon) + roundingError(product));
+}
+
+FilteredDouble FilteredDouble::operator-() const
+{
+    return FilteredDouble(-value, error);
+}
+
+bool FilteredDouble::certain() const
+{
+    if (!std::isfinite(value) || !std::isfinite(error))
+        return false;
+    return error == 0 || std::fabs(value) > error;
+}
+
+int FilteredDouble::sign() const
+{
+    return value > 0 ? 1 : (value < 0 ? -1 : 0);
+}
+
+double FilteredDouble::estimate() const
+{
+    return value;
+}
+
+double Predicates::orient2d( double ax, double ay, double bx, double by, double cx, double cy )
+{
+    double
+            left = (ax - cx) * (by - cy),
+            right = (ay - cy) * (bx - cx),
+            det = left - right,
+            sum;
+
+    if (left > 0)
+    {
+        if (right <= 0)
+            return det;
+        sum = left + right;
+    }
+    else if (left < 0)
+    {
+        if (right >= 0)
+            return det;
+        sum = -left - right;
+    }
+    else
+        return det;
+
+    if (std::fabs(det) >= orientErrorBound * sum)
+        return det;
+
+    Expansion exact =
+            (Expansion(ax) - Expansion(cx)) * (Expansion(by) - Expansion(cy)) -
+            (Expansion(ay) - Expansion(cy)) * (Expansion(bx) - Expansion(cx));
+    return exact.estimate();
+}
+
+int Predicates::orient2d( int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy )
+{
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 Wide;
+    Wide
+            left = Wide(ax - cx) * (by - cy),
+            right = Wide(ay - cy) * (bx - cx);
+    return (left > right) - (left < right);
+#else
+    double det = orient2d(double(ax), double(ay), double(bx), double(by), double(cx), double(cy));
+    return (det > 0) - (det < 0);
+#endif
+}
+
+int Predicates::orient2d( int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t cx, int32_t cy )
+{
+    // differences fit int64, products do not
+    return orient2d(int64_t(ax), int64_t(ay), int64_t(bx), int64_t(by), int64_t(cx), int64_t(cy));
+}
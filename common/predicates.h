@@ -0,0 +1,151 @@
+#ifndef PREDICATES_H
+#define PREDICATES_H
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ * \brief The Expansion class
+ * \details Exact real number as sum of nonoverlapping doubles stored by
+ * \details increasing magnitude (Shewchuk, "Adaptive Precision Floating-
+ * \details Point Arithmetic and Fast Robust Geometric Predicates").
+ * \details Sums and products are exact while no overflow or underflow
+ * \details happens.
+ */
+class Expansion
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param value Initial value.
+     */
+    Expansion( double value = 0 );
+
+    Expansion operator+( Expansion const &rhs ) const;
+    Expansion operator-( Expansion const &rhs ) const;
+    Expansion operator*( Expansion const &rhs ) const;
+    Expansion operator-() const;
+
+    /*!
+     * \brief Get sign function.
+     * \return -1, 0 or 1.
+     */
+    int sign() const;
+
+    /*!
+     * \brief Get approximate value function.
+     * \return Sum of components.
+     */
+    double estimate() const;
+
+private:
+    /*!
+     * \brief Add double to expansion function.
+     * \param value Double to add.
+     */
+    void grow( double value );
+
+    /*!
+     * \brief Multiply expansion by double function.
+     * \param value Multiplier.
+     * \return Product.
+     */
+    Expansion scale( double value ) const;
+
+    std::vector<double> terms;
+};
+
+/*!
+ * \brief The FilteredDouble class
+ * \details Double value with upper bound of its absolute error, tracked
+ * \details through every operation. Operations on exact values that round
+ * \details nothing keep zero bound. Sign is known if bound is below
+ * \details absolute value; otherwise computation is repeated with Expansion.
+ */
+class FilteredDouble
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param value Exact initial value.
+     */
+    FilteredDouble( double value = 0 );
+
+    FilteredDouble operator+( FilteredDouble const &rhs ) const;
+    FilteredDouble operator-( FilteredDouble const &rhs ) const;
+    FilteredDouble operator*( FilteredDouble const &rhs ) const;
+    FilteredDouble operator-() const;
+
+    /*!
+     * \brief Check sign is certain function.
+     * \return true if sign() is the sign of exact value.
+     */
+    bool certain() const;
+
+    /*!
+     * \brief Get sign function.
+     * \return -1, 0 or 1.
+     */
+    int sign() const;
+
+    /*!
+     * \brief Get approximate value function.
+     * \return Value.
+     */
+    double estimate() const;
+
+private:
+    FilteredDouble( double value, double error );
+
+    double value, error;
+};
+
+/*!
+ * \brief Evaluate sign of expression exactly function.
+ * \details Expression is a functor with template operator() taking no
+ * \details arguments but number type, e.g. T operator()( T* ) const.
+ * \details It is evaluated with FilteredDouble first and with Expansion
+ * \details if filter fails.
+ * \param expression Expression.
+ * \return -1, 0 or 1.
+ */
+template<class Expression>
+int exactSign( Expression const &expression )
+{
+    FilteredDouble approx = expression(static_cast<FilteredDouble *>(nullptr));
+    if (approx.certain())
+        return approx.sign();
+    return expression(static_cast<Expansion *>(nullptr)).sign();
+}
+
+/*!
+ * \brief The Predicates struct
+ * \details Robust geometric predicates.
+ */
+struct Predicates
+{
+    /*!
+     * \brief Orientation test function.
+     * \details Exact sign of (b - a) x (c - a): positive if a, b, c go
+     * \details counterclockwise, negative if clockwise, zero if collinear.
+     * \details Fast double evaluation is used when its error bound allows.
+     * \return Value having the sign of determinant.
+     */
+    static double orient2d( double ax, double ay, double bx, double by, double cx, double cy );
+
+    /*!
+     * \brief Orientation test function for integer coordinates.
+     * \details Exact in 128 bit arithmetic while coordinates are below
+     * \details 2^62 by absolute value.
+     * \return Sign of determinant.
+     */
+    static int orient2d( int64_t ax, int64_t ay, int64_t bx, int64_t by, int64_t cx, int64_t cy );
+
+    /*!
+     * \brief Orientation test function for 32 bit integer coordinates.
+     * \return Sign of determinant.
+     */
+    static int orient2d( int32_t ax, int32_t ay, int32_t bx, int32_t by, int32_t cx, int32_t cy );
+};
+
+#endif // PREDICATES_H
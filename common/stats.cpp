@@ -0,0 +1,161 @@
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "stats.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define HAVE_GETRUSAGE
+#endif
+
+namespace
+{
+
+struct PhaseTime
+{
+    char const *name;
+    double seconds;
+    uint64_t calls;
+};
+
+struct Counter
+{
+    char const *name;
+    uint64_t value;
+};
+
+std::mutex mutex;
+std::vector<PhaseTime> phases;
+std::vector<Counter> counters;
+thread_local bool muted = false;
+
+Counter & counter( char const *name )
+{
+    for (auto &c : counters)
+        if (!strcmp(c.name, name))
+            return c;
+    counters.push_back(Counter{name, 0});
+    return counters.back();
+}
+
+//! Names are literals of the code, there is nothing to escape
+void printName( std::ostream &os, char const *name )
+{
+    os << '"' << name << '"';
+}
+
+double seconds( std::chrono::steady_clock::time_point start )
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+Stats::Phase::Phase( const char *name ) : name(name), muted(::muted),
+    start(std::chrono::steady_clock::now())
+{}
+
+Stats::Phase::~Phase()
+{
+    if (muted)
+        return;
+
+    double elapsed = seconds(start);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto &phase : phases)
+        if (!strcmp(phase.name, name))
+        {
+            phase.seconds += elapsed;
+            phase.calls++;
+            return;
+        }
+    phases.push_back(PhaseTime{name, elapsed, 1});
+}
+
+Stats::Mute::Mute() : previous(muted)
+{
+    muted = true;
+}
+
+Stats::Mute::~Mute()
+{
+    muted = previous;
+}
+
+Stats::Report::Report( std::ostream *os ) : os(os), start(std::chrono::steady_clock::now()) {}
+
+Stats::Report::~Report()
+{
+    if (!os)
+        return;
+    if (enabled())
+        print(*os, seconds(start));
+    else
+        *os << "statistics are not collected, build with STATS option on\n";
+}
+
+bool Stats::enabled()
+{
+#ifdef STATS_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Stats::add( const char *name, uint64_t value )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    counter(name).value += value;
+}
+
+void Stats::max( const char *name, uint64_t value )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &c = counter(name);
+    if (c.value < value)
+        c.value = value;
+}
+
+uint64_t Stats::peakResidentKb()
+{
+#ifdef HAVE_GETRUSAGE
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage))
+        return 0;
+#ifdef __APPLE__
+    // bytes there, kilobytes elsewhere
+    return static_cast<uint64_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+void Stats::print( std::ostream &os, double totalSeconds )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto flags = os.flags();
+    auto precision = os.precision(6);
+    os << std::fixed << "{\"total_seconds\": " << totalSeconds << ", \"phases\": {";
+    for (size_t i = 0; i < phases.size(); i++)
+    {
+        os << (i ? ", " : "");
+        printName(os, phases[i].name);
+        os << ": {\"seconds\": " << phases[i].seconds << ", \"calls\": " << phases[i].calls << '}';
+    }
+    os << "}, \"counters\": {";
+    for (size_t i = 0; i < counters.size(); i++)
+    {
+        os << (i ? ", " : "");
+        printName(os, counters[i].name);
+        os << ": " << counters[i].value;
+    }
+    os << "}, \"peak_rss_kb\": " << peakResidentKb() << "}\n";
+    os.precision(precision);
+    os.flags(flags);
+}
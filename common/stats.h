@@ -0,0 +1,139 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+/*!
+ * \brief The Stats class
+ * \details Process wide phase timers and counters printed as JSON report.
+ * \details Collected only if built with STATS_ENABLED defined (CMake
+ * \details option STATS), macros below expand to nothing otherwise.
+ * \details Phases are wall clock time summed over calls and may nest,
+ * \details counters are summed or maximized. Both may be updated from any
+ * \details thread; hot loops should accumulate locally and update once.
+ */
+class Stats
+{
+public:
+    /*!
+     * \brief The Phase class
+     * \details Adds time from construction to destruction to the phase.
+     */
+    class Phase
+    {
+    public:
+        /*!
+         * \brief Class constructor.
+         * \param name Phase name, snake case string literal.
+         */
+        explicit Phase( char const *name );
+
+        ~Phase();
+
+        Phase( Phase const & ) = delete;
+        Phase & operator=( Phase const & ) = delete;
+
+    private:
+        char const *name;
+        bool muted;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /*!
+     * \brief The Mute class
+     * \details Phases of current thread are not timed while it exists:
+     * \details parallel tasks would add up time of the same phase.
+     */
+    class Mute
+    {
+    public:
+        Mute();
+        ~Mute();
+
+        Mute( Mute const & ) = delete;
+        Mute & operator=( Mute const & ) = delete;
+
+    private:
+        bool previous;
+    };
+
+    /*!
+     * \brief The Report class
+     * \details Prints report on destruction, total time is counted from
+     * \details construction.
+     */
+    class Report
+    {
+    public:
+        /*!
+         * \brief Class constructor.
+         * \param os Stream to print report to, nullptr -- do not print.
+         */
+        explicit Report( std::ostream *os );
+
+        ~Report();
+
+        Report( Report const & ) = delete;
+        Report & operator=( Report const & ) = delete;
+
+    private:
+        std::ostream *os;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /*!
+     * \brief Check statistics are collected function.
+     * \return true if built with STATS_ENABLED.
+     */
+    static bool enabled();
+
+    /*!
+     * \brief Add to counter function.
+     * \param name Counter name, snake case string literal.
+     * \param value Value to add.
+     */
+    static void add( char const *name, uint64_t value );
+
+    /*!
+     * \brief Raise counter to value function.
+     * \param name Counter name, snake case string literal.
+     * \param value Value counter is raised to if less.
+     */
+    static void max( char const *name, uint64_t value );
+
+    /*!
+     * \brief Get peak resident set size function.
+     * \return Peak resident set size in kilobytes, 0 if unknown.
+     */
+    static uint64_t peakResidentKb();
+
+    /*!
+     * \brief Print report function.
+     * \details {"total_seconds": t, "phases": {"name": {"seconds": s,
+     * \details "calls": n}, ...}, "counters": {"name": v, ...},
+     * \details "peak_rss_kb": r}, phases and counters in order of first update.
+     * \param os Output stream.
+     * \param totalSeconds Total time.
+     */
+    static void print( std::ostream &os, double totalSeconds );
+};
+
+#ifdef STATS_ENABLED
+#define STATS_CONCAT_IMPL(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_IMPL(a, b)
+#define STATS_PHASE(name) Stats::Phase STATS_CONCAT(statsPhase, __LINE__)(name)
+#define STATS_MUTE() Stats::Mute STATS_CONCAT(statsMute, __LINE__)
+#define STATS_ADD(name, value) Stats::add(name, value)
+#define STATS_MAX(name, value) Stats::max(name, value)
+#define STATS_ONLY(...) __VA_ARGS__
+#else
+#define STATS_PHASE(name)
+#define STATS_MUTE()
+#define STATS_ADD(name, value)
+#define STATS_MAX(name, value)
+#define STATS_ONLY(...)
+#endif
+
+#endif // STATS_H
@@ -0,0 +1,78 @@
+#include <algorithm>
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool( unsigned threads ) :
+    task(nullptr), taskCount(0), nextTask(0), finishedTasks(0),
+    generation(0), stop(false)
+{
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 1; i < threads; i++)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wakeUp.notify_all();
+    for (auto &w : workers)
+        w.join();
+}
+
+unsigned ThreadPool::size() const
+{
+    return static_cast<unsigned>(workers.size()) + 1;
+}
+
+void ThreadPool::run( size_t tasks, std::function<void( size_t )> const &task )
+{
+    if (tasks == 0)
+        return;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    this->task = &task;
+    taskCount = tasks;
+    nextTask = 0;
+    finishedTasks = 0;
+    generation++;
+    wakeUp.notify_all();
+
+    drain(lock);
+    jobDone.wait(lock, [this]() { return finishedTasks == taskCount; });
+    this->task = nullptr;
+}
+
+void ThreadPool::drain( std::unique_lock<std::mutex> &lock )
+{
+    while (nextTask < taskCount)
+    {
+        size_t idx = nextTask++;
+        auto const &body = *task;
+
+        lock.unlock();
+        body(idx);
+        lock.lock();
+
+        if (++finishedTasks == taskCount)
+            jobDone.notify_all();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned long seen = generation;
+
+    while (true)
+    {
+        wakeUp.wait(lock, [this, &seen]() { return stop || generation != seen; });
+        if (stop)
+            return;
+        seen = generation;
+        drain(lock);
+    }
+}
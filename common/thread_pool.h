@@ -0,0 +1,65 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/*!
+ * \brief The ThreadPool class
+ * \details Fixed set of worker threads running index-parallel jobs.
+ * \details The calling thread takes part in every job, so a pool of
+ * \details size 1 has no workers and runs everything inline.
+ */
+class ThreadPool
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param threads Total number of threads (0 -- hardware concurrency).
+     */
+    explicit ThreadPool( unsigned threads );
+
+    /*!
+     * \brief Class destructor. Joins workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool( ThreadPool const & ) = delete;
+    ThreadPool & operator=( ThreadPool const & ) = delete;
+
+    /*!
+     * \brief Get number of threads function.
+     * \return Number of threads including the calling one.
+     */
+    unsigned size() const;
+
+    /*!
+     * \brief Run job function. Blocks until every task is done.
+     * \param tasks Number of tasks.
+     * \param task Task body, called once for each index in [0, tasks).
+     */
+    void run( size_t tasks, std::function<void( size_t )> const &task );
+
+private:
+    /*!
+     * \brief Take and execute tasks of current job function.
+     * \param lock Locked pool mutex.
+     */
+    void drain( std::unique_lock<std::mutex> &lock );
+
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wakeUp, jobDone;
+
+    std::function<void( size_t )> const *task;
+    size_t taskCount, nextTask, finishedTasks;
+    unsigned long generation;
+    bool stop;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <limits>
+#include "akl_toussaint_filter.h"
+
+size_t AklToussaintFilter::apply( PointSet const &points, std::vector<Vector> &survivors,
+                                  ThreadPool *pool )
+{
+    size_t n = points.size();
+    Coord const
+            *x = points.x().data(),
+            *y = points.y().data();
+
+    survivors.clear();
+    if (n < octagonSize)
+    {
+        survivors = points.toVectors();
+        return 0;
+    }
+
+    size_t idx[octagonSize];
+    findExtremes(x, y, n, idx);
+
+    // octagon edges, duplicated vertices skipped
+    double ax[octagonSize], ay[octagonSize], dx[octagonSize], dy[octagonSize];
+    int edges = 0;
+    for (int k = 0; k < octagonSize; k++)
+    {
+        size_t a = idx[k], b = idx[(k + 1) % octagonSize];
+        if (x[a] == x[b] && y[a] == y[b])
+            continue;
+        ax[edges] = x[a];
+        ay[edges] = y[a];
+        dx[edges] = double(x[b]) - x[a];
+        dy[edges] = double(y[b]) - y[a];
+        edges++;
+    }
+    if (edges < 3)
+    {
+        survivors = points.toVectors();
+        return 0;
+    }
+    // pad with copies of the first edge to keep the loop trip count fixed
+    for (int k = edges; k < octagonSize; k++)
+    {
+        ax[k] = ax[0];
+        ay[k] = ay[0];
+        dx[k] = dx[0];
+        dy[k] = dy[0];
+    }
+
+    // error bound of cross product sign (Shewchuk's ccwerrboundA)
+    const double
+            eps = std::numeric_limits<double>::epsilon() / 2,
+            bound = (3.0 + 16.0 * eps) * eps;
+
+    std::vector<unsigned char> keep(n);
+    auto test = [&]( size_t first, size_t last )
+    {
+        for (size_t i = first; i < last; i++)
+        {
+            unsigned char inside = 1;
+            for (int k = 0; k < octagonSize; k++)
+            {
+                double
+                        l = dx[k] * (y[i] - ay[k]),
+                        r = dy[k] * (x[i] - ax[k]);
+                inside &= (l - r > bound * (std::fabs(l) + std::fabs(r)));
+            }
+            keep[i] = !inside;
+        }
+    };
+
+    if (pool != nullptr && pool->size() > 1)
+    {
+        size_t chunks = pool->size();
+        pool->run(chunks, [&]( size_t c )
+        {
+            test(n * c / chunks, n * (c + 1) / chunks);
+        });
+    }
+    else
+        test(0, n);
+
+    for (size_t i = 0; i < n; i++)
+        if (keep[i])
+            survivors.push_back(points[i]);
+
+    return n - survivors.size();
+}
+
+void AklToussaintFilter::findExtremes( Coord const *x, Coord const *y, size_t n,
+                                       size_t idx[octagonSize] )
+{
+    /* counterclockwise: min y, max x - y, max x, max x + y,
+     *                   max y, min x - y, min x, min x + y */
+    double best[octagonSize];
+    for (int k = 0; k < octagonSize; k++)
+    {
+        idx[k] = 0;
+        best[k] = -std::numeric_limits<double>::infinity();
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double
+                xi = x[i],
+                yi = y[i],
+                s = xi + yi,
+                d = xi - yi,
+                key[octagonSize] = {-yi, d, xi, s, yi, -d, -xi, -s};
+        for (int k = 0; k < octagonSize; k++)
+            if (key[k] > best[k])
+            {
+                best[k] = key[k];
+                idx[k] = i;
+            }
+    }
+}
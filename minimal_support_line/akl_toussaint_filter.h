@@ -0,0 +1,45 @@
+#ifndef AKL_TOUSSAINT_FILTER_H
+#define AKL_TOUSSAINT_FILTER_H
+
+#include <vector>
+#include "primitives.h"
+#include "point_set.h"
+#include "thread_pool.h"
+
+/*!
+ * \brief The AklToussaintFilter class
+ * \details Convex hull pre-filter: finds extreme points in directions
+ * \details x, y, x + y, x - y and drops every point lying strictly inside
+ * \details the octagon they span. Such points can not be hull vertices.
+ * \details Tests run in double with a sign error bound, so a point is kept
+ * \details unless it is certainly inside.
+ */
+class AklToussaintFilter
+{
+public:
+    /*!
+     * \brief Drop interior points function.
+     * \param points[IN] Points to filter.
+     * \param survivors[OUT] Points that are not culled, in input order.
+     * \param pool Thread pool to run inside test on, may be nullptr.
+     * \return Number of culled points.
+     */
+    static size_t apply( PointSet const &points, std::vector<Vector> &survivors,
+                         ThreadPool *pool = nullptr );
+
+private:
+    //! Number of octagon vertices
+    static const int octagonSize = 8;
+
+    /*!
+     * \brief Find octagon vertices function.
+     * \param x x coordinates.
+     * \param y y coordinates.
+     * \param n Number of points.
+     * \param idx[OUT] Indices of extreme points in counterclockwise order.
+     */
+    static void findExtremes( Coord const *x, Coord const *y, size_t n,
+                              size_t idx[octagonSize] );
+};
+
+#endif // AKL_TOUSSAINT_FILTER_H
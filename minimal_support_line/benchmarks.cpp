@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "point_generator.h"
+#include "convex_hull_graham.h"
+#include "minimal_support_line.h"
+#include "thread_pool.h"
+
+//! Synthetic point distributions
+enum class Distribution { UNIFORM, CLUSTERS, CIRCLE, PARABOLA };
+
+namespace
+{
+
+const uint64_t seed = 20240611;
+
+/*!
+ * \brief Generate points function.
+ * \param distribution Distribution.
+ * \param n Number of points.
+ * \param state Benchmark state, skipped if points do not fit coordinates.
+ * \return Points.
+ */
+PointSet generate( Distribution distribution, std::size_t n, benchmark::State &state )
+{
+    PointGenerator generator(seed);
+    switch (distribution)
+    {
+    case Distribution::UNIFORM:
+        return generator.uniform(n);
+    case Distribution::CLUSTERS:
+        return generator.clusters(n);
+    case Distribution::CIRCLE:
+        return generator.circle(n);
+    case Distribution::PARABOLA:
+    {
+        bool ok;
+        auto points = generator.parabola(n, &ok);
+        if (!ok)
+            state.SkipWithError("parabola does not fit coordinate type");
+        return points;
+    }
+    }
+    return PointSet();
+}
+
+//! Point counts from 1e3 to 1e8
+std::vector<int64_t> sizes()
+{
+    return benchmark::CreateRange(1000, 100000000, 10);
+}
+
+} // namespace
+
+/*!
+ * \brief Sort points by Vector comparator benchmark.
+ * \details Arguments: number of points.
+ */
+void BM_VectorLess( benchmark::State &state )
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto points = PointGenerator(seed).uniform(n).toVectors();
+    std::vector<Vector> sorted;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sorted = points;
+        state.ResumeTiming();
+        std::sort(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_VectorLess)->ArgsProduct({sizes()})->Unit(benchmark::kMillisecond);
+
+/*!
+ * \brief Build convex hull benchmark.
+ * \details Arguments: number of points, threads (0 -- all cores).
+ */
+void BM_BuildConvexHull( benchmark::State &state, Distribution distribution )
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto points = generate(distribution, n, state);
+    if (state.error_occurred())
+        return;
+    ThreadPool pool(static_cast<unsigned>(state.range(1)));
+
+    ConvexHullGraham::Hull hull;
+    size_t culled = 0;
+    for (auto _ : state)
+    {
+        ConvexHullGraham ch(points, &pool);
+        hull = ch.buildConvexHull();
+        culled = ch.culledPoints();
+        benchmark::DoNotOptimize(hull.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["hull"] = static_cast<double>(hull.size());
+    state.counters["culled"] = static_cast<double>(culled);
+}
+BENCHMARK_CAPTURE(BM_BuildConvexHull, uniform, Distribution::UNIFORM)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_BuildConvexHull, clusters, Distribution::CLUSTERS)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_BuildConvexHull, circle, Distribution::CIRCLE)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_BuildConvexHull, parabola, Distribution::PARABOLA)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/*!
+ * \brief Find minimal support line of built hull benchmark.
+ * \details Arguments: number of points, threads (0 -- all cores).
+ */
+void BM_MinimalSupportLine( benchmark::State &state, Distribution distribution )
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    auto points = generate(distribution, n, state);
+    if (state.error_occurred())
+        return;
+    ThreadPool pool(static_cast<unsigned>(state.range(1)));
+    auto hull = ConvexHullGraham(points, &pool).buildConvexHull();
+
+    for (auto _ : state)
+    {
+        MinimalSupportLine msl(&pool);
+        benchmark::DoNotOptimize(msl.findMinimalSupportLine(points, hull));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["hull"] = static_cast<double>(hull.size());
+}
+BENCHMARK_CAPTURE(BM_MinimalSupportLine, uniform, Distribution::UNIFORM)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MinimalSupportLine, clusters, Distribution::CLUSTERS)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MinimalSupportLine, circle, Distribution::CIRCLE)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_MinimalSupportLine, parabola, Distribution::PARABOLA)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+#ifndef COMPENSATED_SUM_H
+#define COMPENSATED_SUM_H
+
+#include <cmath>
+
+/*!
+ * \brief The CompensatedSum class
+ * \details Neumaier summation: rounding error of every addition is kept in
+ * \details a separate term, so the sum is as accurate as if it was computed
+ * \details in twice the precision, whatever the order of magnitudes is.
+ * \details Subtraction is addition of negated value.
+ */
+class CompensatedSum
+{
+public:
+    /*!
+     * \brief Class constructor.
+     */
+    CompensatedSum() : sum(0), compensation(0) {}
+
+    /*!
+     * \brief Add value function.
+     * \param value Value.
+     */
+    void add( double value )
+    {
+        double t = sum + value;
+        if (std::abs(sum) >= std::abs(value))
+            compensation += (sum - t) + value;
+        else
+            compensation += (value - t) + sum;
+        sum = t;
+    }
+
+    /*!
+     * \brief Add value to sum and its compensation function.
+     * \details Knuth's TwoSum: no branches, so independent sums kept in
+     * \details arrays are added in vector registers.
+     * \param sum[IN, OUT] Sum.
+     * \param compensation[IN, OUT] Accumulated rounding error of sum.
+     * \param value Value.
+     */
+    static void twoSum( double &sum, double &compensation, double value )
+    {
+        double
+                t = sum + value,
+                v = t - sum;
+        compensation += (sum - (t - v)) + (value - v);
+        sum = t;
+    }
+
+    /*!
+     * \brief Get sum function.
+     * \return Compensated sum.
+     */
+    double value() const
+    {
+        return sum + compensation;
+    }
+
+private:
+    double sum, compensation;
+};
+
+#endif // COMPENSATED_SUM_H
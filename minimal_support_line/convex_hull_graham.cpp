@@ -1,67 +1,125 @@
-#include <cassert>
 #include <algorithm>
 #include <cmath>
+#include <tuple>
 #include "convex_hull_graham.h"
+#include "akl_toussaint_filter.h"
+#include "predicates.h"
+#include "stats.h"
 
-ConvexHullGraham::ConvexHullGraham(const std::vector<Vector> &points) : points(points)
+const size_t ConvexHullGraham::minChunkSize = 1 << 14;
+
+ConvexHullGraham::ConvexHullGraham(const PointSet &points, ThreadPool *pool) :
+    points(points), pool(pool), culled(0)
 {}
 
-std::list<Vector> ConvexHullGraham::buildConvexHull()
+ConvexHullGraham::Hull ConvexHullGraham::buildConvexHull()
+{
+    std::vector<Vector> candidates;
+    {
+        STATS_PHASE("cull");
+        culled = AklToussaintFilter::apply(points, candidates, pool);
+        STATS_ADD("points_culled", culled);
+
+        if (pool != nullptr && pool->size() > 1 &&
+            candidates.size() >= minChunkSize * pool->size())
+            reduceToSubHulls(candidates);
+    }
+
+    return grahamScan(candidates);
+}
+
+size_t ConvexHullGraham::culledPoints() const
+{
+    return culled;
+}
+
+ConvexHullGraham::Hull ConvexHullGraham::grahamScan( std::vector<Vector> &points )
 {
-    std::list<Vector> hull;
+    Hull hull;
+    if (points.empty())
+        return hull;
 
     auto p0_it = std::min_element(points.begin(), points.end());
-    assert(p0_it != points.end());
     auto p0 = *p0_it;
     points.erase(p0_it);
 
-    std::sort(points.begin(), points.end(),
-              [&p0]( Vector const& lhs, Vector const &rhs )
+    if (points.empty())
+        return {p0};
+
     {
-        auto v0 = lhs - p0, v1 = rhs - p0;
-        auto crossprod = v0.crossProd(v1);
-        if (std::fabs(crossprod) > Vector::tolerance)
-            return crossprod > Vector::tolerance;
-        return lhs.len2() < rhs.len2();
-    });
+        STATS_PHASE("hull_sort");
+        std::sort(points.begin(), points.end(),
+                  [&p0]( Vector const& lhs, Vector const &rhs )
+        {
+            double turn = Predicates::orient2d(p0.x(), p0.y(), lhs.x(), lhs.y(), rhs.x(), rhs.y());
+            if (turn != 0)
+                return turn > 0;
+            // on a ray from the lowest point distance grows with lexicographic order
+            if (!(lhs == rhs))
+                return lhs < rhs;
+            // equal points: keep order independent of input permutation
+            return lhs.id() < rhs.id();
+        });
+    }
+
+    STATS_PHASE("scan");
+    STATS_ONLY(uint64_t pops = 0;)
 
-    /* top is end */
-    hull.insert(hull.end(), p0);
-    hull.insert(hull.end(), points[0]);
+    /* top is back */
+    hull.push_back(p0);
+    hull.push_back(points[0]);
 
     for (size_t i = 1; i < points.size(); i++)
     {
-        bool is_right_turn = true;
-        while (is_right_turn)
+        while (hull.size() > 1 &&
+               !isLeftTurn(hull[hull.size() - 2], hull.back(), points[i]))
         {
-            auto top_it = hull.rbegin();
-            if (top_it != hull.rend())
-            {
-                std::list<Vector>::reverse_iterator prev_top_it = hull.rbegin();
-                prev_top_it++;
-                if (prev_top_it != hull.rend())
-                {
-                    is_right_turn = !isLeftTurn(*prev_top_it, *top_it, points[i]);
-
-                    if (is_right_turn)
-                        hull.remove(*top_it);
-                }
-                else break;
-            }
-            else
-                break;
+            hull.pop_back();
+            STATS_ONLY(pops++;)
         }
-        hull.insert(hull.end(), points[i]);
+        hull.push_back(points[i]);
     }
+    STATS_ADD("hull_pops", pops);
 
     return hull;
 }
 
+void ConvexHullGraham::reduceToSubHulls( std::vector<Vector> &points )
+{
+    auto exactLess = []( Vector const &lhs, Vector const &rhs )
+    {
+        return std::make_tuple(lhs.x(), lhs.y(), lhs.id()) <
+               std::make_tuple(rhs.x(), rhs.y(), rhs.id());
+    };
+
+    size_t chunks = pool->size();
+    std::vector<char> keep(points.size());
+
+    pool->run(chunks, [&]( size_t c )
+    {
+        STATS_MUTE();
+        size_t
+                first = points.size() * c / chunks,
+                last = points.size() * (c + 1) / chunks;
+        std::vector<Vector> chunk(points.begin() + first, points.begin() + last);
+
+        // points strictly inside a sub-hull are strictly inside the whole hull
+        auto subHull = grahamScan(chunk);
+        std::sort(subHull.begin(), subHull.end(), exactLess);
+
+        for (size_t i = first; i < last; i++)
+            keep[i] = std::binary_search(subHull.begin(), subHull.end(),
+                                         points[i], exactLess);
+    });
+
+    size_t kept = 0;
+    for (size_t i = 0; i < points.size(); i++)
+        if (keep[i])
+            points[kept++] = points[i];
+    points.resize(kept);
+}
+
 bool ConvexHullGraham::isLeftTurn(const Vector &p1, const Vector &p2, const Vector &p3)
 {
-    // vector p1p2
-    Vector
-            p1p2 = p2 - p1,
-            p2p3 = p3 - p2;
-    return p1p2.crossProd(p2p3) >= -Vector::tolerance;
+    return Predicates::orient2d(p1.x(), p1.y(), p2.x(), p2.y(), p3.x(), p3.y()) > 0;
 }
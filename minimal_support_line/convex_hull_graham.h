@@ -2,27 +2,67 @@
 #define CONVEXHULLGRAHAM_H
 
 #include <vector>
-#include <list>
 #include "primitives.h"
+#include "point_set.h"
+#include "thread_pool.h"
 
 class ConvexHullGraham
 {
 public:
+    //! Convex hull: contiguous counterclockwise vertex list
+    using Hull = std::vector<Vector>;
+
     /*!
      * \brief Class constructor.
-     * \param points Points to build convex hull over.
+     * \param points Points to build convex hull over. Must outlive object.
+     * \param pool Thread pool for parallel mode, nullptr for sequential one.
      */
-    ConvexHullGraham( std::vector<Vector> const &points );
+    ConvexHullGraham( PointSet const &points, ThreadPool *pool = nullptr );
 
     /*!
      * \brief Build convex hull function.
+     * \details Points strictly inside the extreme points octagon are culled
+     * \details first (see AklToussaintFilter).
+     * \details In parallel mode points are split into one chunk per thread,
+     * \details sub-hulls are built concurrently and only their vertices go
+     * \details to the final scan. Result is the same as in sequential mode.
      * \return Ordered points of convex hull.
      */
-    std::list<Vector> buildConvexHull();
+    Hull buildConvexHull();
+
+    /*!
+     * \brief Get number of points culled by last build function.
+     * \return Number of culled points.
+     */
+    size_t culledPoints() const;
 private:
+    /*!
+     * \brief Graham scan function.
+     * \param points[IN, OUT] Points to build hull over, reordered on exit.
+     * \return Ordered points of convex hull.
+     */
+    static Hull grahamScan( std::vector<Vector> &points );
+
+    /*!
+     * \brief Drop points that are not sub-hull vertices function.
+     * \details Keeps relative order of remaining points.
+     * \param points[IN, OUT] Points to reduce.
+     */
+    void reduceToSubHulls( std::vector<Vector> &points );
+
+    /*!
+     * \brief Check turn is strictly counterclockwise function.
+     * \details Exact, see Predicates::orient2d.
+     * \return true if p1, p2, p3 go counterclockwise.
+     */
     static bool isLeftTurn( Vector const &p1, Vector const &p2, Vector const &p3);
 
-    std::vector<Vector> points;
+    //! Minimal number of points per thread to go parallel
+    static const size_t minChunkSize;
+
+    PointSet const &points;
+    ThreadPool *pool;
+    size_t culled;
 };
 
 #endif // CONVEXHULLGRAHAM_H
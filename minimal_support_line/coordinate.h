@@ -0,0 +1,96 @@
+#ifndef COORDINATE_H
+#define COORDINATE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "binary_format.h"
+
+#ifndef COORD_TYPE
+#define COORD_TYPE double
+#endif
+
+/*!
+ * \brief Coordinate type.
+ * \details Chosen at build time: cmake -DCOORD_TYPE=int32_t. Supported are
+ * \details float, double, int32_t and int64_t. Integer coordinates are
+ * \details compared and turned exactly; int64_t ones must not exceed 2^53
+ * \details by absolute value (text input and culling go through double).
+ */
+using Coord = COORD_TYPE;
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef __int128 Int128;
+#else
+typedef double Int128;
+#endif
+
+/*!
+ * \brief The CoordinateTraits struct
+ * \details Product is a type holding product of two coordinates, exact
+ * \details for integer ones. Scalar is the binary file column type.
+ */
+template<class T>
+struct CoordinateTraits;
+
+template<>
+struct CoordinateTraits<float>
+{
+    using Product = double;
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::FLOAT32; }
+};
+
+template<>
+struct CoordinateTraits<double>
+{
+    using Product = double;
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::FLOAT64; }
+};
+
+template<>
+struct CoordinateTraits<int32_t>
+{
+    using Product = int64_t;
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::INT32; }
+};
+
+template<>
+struct CoordinateTraits<int64_t>
+{
+    using Product = Int128;
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::INT64; }
+};
+
+/*!
+ * \brief Convert number to coordinate function.
+ * \param value Number.
+ * \param coord[OUT] Coordinate.
+ * \return false if integer coordinate can not hold number exactly.
+ */
+inline bool toCoordinate( double value, Coord &coord )
+{
+    const double lowest = static_cast<double>(std::numeric_limits<Coord>::lowest());
+    if (std::numeric_limits<Coord>::is_integer &&
+        !(value >= lowest && value < -lowest && value == std::floor(value)))
+        return false;
+    coord = static_cast<Coord>(value);
+    return true;
+}
+
+/*!
+ * \brief Check binary column can be read as coordinates function.
+ * \details Integer builds read only integer columns not wider than Coord,
+ * \details floating point builds read any column.
+ * \param scalar Column type.
+ * \return true if readable.
+ */
+inline bool isCoordinateScalar( BinaryFormat::Scalar scalar )
+{
+    if (!std::numeric_limits<Coord>::is_integer)
+        return true;
+    return (scalar == BinaryFormat::Scalar::INT32 || scalar == BinaryFormat::Scalar::INT64) &&
+            BinaryFormat::scalarSize(scalar) <= sizeof(Coord);
+}
+
+#endif // COORDINATE_H
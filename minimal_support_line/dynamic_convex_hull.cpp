@@ -0,0 +1,587 @@
+#include <algorithm>
+#include <iterator>
+#include "dynamic_convex_hull.h"
+#include "predicates.h"
+
+const uint32_t DynamicConvexHull::NONE = UINT32_MAX;
+
+namespace
+{
+
+/*!
+ * \brief Difference of heights of two nonvertical lines at x, scaled by
+ * \brief positive factor.
+ * \details Lines go through (a0x, a0y), (a1x, a1y) and (b0x, b0y), (b1x, b1y),
+ * \details a1x > a0x, b1x > b0x.
+ */
+struct HeightDifference
+{
+    double a0x, a0y, a1x, a1y, b0x, b0y, b1x, b1y, x;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        T
+                dax = T(a1x) - T(a0x), day = T(a1y) - T(a0y),
+                dbx = T(b1x) - T(b0x), dby = T(b1y) - T(b0y),
+                ya = T(a0y) * dax + day * (T(x) - T(a0x)),
+                yb = T(b0y) * dbx + dby * (T(x) - T(b0x));
+        return ya * dbx - yb * dax;
+    }
+};
+
+} // namespace
+
+bool DynamicConvexHull::LeafLess::operator()(uint32_t lhs, uint32_t rhs) const
+{
+    return (*nodes)[lhs].point < (*nodes)[rhs].point;
+}
+
+DynamicConvexHull::DynamicConvexHull() :
+    root(NONE), seed(2463534242u), count(0),
+    chains{ChainSet(LeafLess{&nodes}), ChainSet(LeafLess{&nodes})}
+{}
+
+void DynamicConvexHull::insert(const Vector &point, Update *update)
+{
+    if (update)
+    {
+        update->removed.clear();
+        update->added.clear();
+    }
+
+    auto key = std::make_pair(point.x(), point.y());
+    auto found = points.lower_bound(key);
+    if (found != points.end() && found->first == key)
+    {
+        uint32_t leaf = found->second.first;
+        std::vector<int> &others = found->second.second;
+        int id = nodes[leaf].point.id();
+        if (id == point.id() || std::find(others.begin(), others.end(), point.id()) != others.end())
+            return;
+        count++;
+        if (point.id() > id)
+        {
+            others.push_back(point.id());
+            return;
+        }
+        others.push_back(id);
+        Vector previous = nodes[leaf].point;
+        nodes[leaf].point = point;
+        reportRepresentative(leaf, previous, update);
+        return;
+    }
+
+    count++;
+    uint32_t leaf = allocate();
+    Node &node = nodes[leaf];
+    node.left = node.right = node.parent = NONE;
+    node.first = node.last = leaf;
+    node.stale = false;
+    node.point = point;
+    auto inserted = points.emplace_hint(found, key, std::make_pair(leaf, std::vector<int>()));
+
+    // any leaf next to the new one in order is a place to split
+    uint32_t neighbour = NONE;
+    if (inserted != points.begin())
+        neighbour = std::prev(inserted)->second.first;
+    else if (std::next(inserted) != points.end())
+        neighbour = std::next(inserted)->second.first;
+    link(leaf, neighbour);
+    addToChain(leaf, UPPER, update);
+    addToChain(leaf, LOWER, update);
+}
+
+bool DynamicConvexHull::erase(const Vector &point, Update *update)
+{
+    if (update)
+    {
+        update->removed.clear();
+        update->added.clear();
+    }
+
+    auto found = points.find(std::make_pair(point.x(), point.y()));
+    if (found == points.end())
+        return false;
+
+    uint32_t leaf = found->second.first;
+    std::vector<int> &others = found->second.second;
+    if (nodes[leaf].point.id() != point.id())
+    {
+        auto other = std::find(others.begin(), others.end(), point.id());
+        if (other == others.end())
+            return false;
+        count--;
+        others.erase(other);
+        return true;
+    }
+    count--;
+
+    if (!others.empty())
+    {
+        // smallest of equal points takes over
+        auto next = std::min_element(others.begin(), others.end());
+        Vector previous = nodes[leaf].point;
+        nodes[leaf].point = Vector(point.x(), point.y(), *next);
+        others.erase(next);
+        reportRepresentative(leaf, previous, update);
+        return true;
+    }
+    points.erase(found);
+
+    // leaf stays allocated while chains still compare against it
+    unlink(leaf);
+    removeFromChain(leaf, UPPER, update);
+    removeFromChain(leaf, LOWER, update);
+    freeNodes.push_back(leaf);
+    return true;
+}
+
+ConvexHullGraham::Hull DynamicConvexHull::hull() const
+{
+    ConvexHullGraham::Hull result;
+    ChainSet const &lower = chains[LOWER], &upper = chains[UPPER];
+    result.reserve(lower.size() + upper.size());
+
+    for (uint32_t leaf : lower)
+        result.push_back(nodes[leaf].point);
+    // upper chain backwards without ends shared with lower one
+    if (upper.size() > 2)
+        for (auto it = std::next(upper.rbegin()); it != std::prev(upper.rend()); ++it)
+            result.push_back(nodes[*it].point);
+    return result;
+}
+
+size_t DynamicConvexHull::size() const
+{
+    return count;
+}
+
+bool DynamicConvexHull::isLeaf(uint32_t node) const
+{
+    return nodes[node].left == NONE;
+}
+
+uint32_t DynamicConvexHull::allocate()
+{
+    if (!freeNodes.empty())
+    {
+        uint32_t node = freeNodes.back();
+        freeNodes.pop_back();
+        return node;
+    }
+    nodes.emplace_back();
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+void DynamicConvexHull::link(uint32_t leaf, uint32_t neighbour)
+{
+    if (neighbour == NONE)
+    {
+        root = leaf;
+        return;
+    }
+
+    uint32_t inner = allocate();
+    bool leafFirst = nodes[leaf].point < nodes[neighbour].point;
+    uint32_t parent = nodes[neighbour].parent;
+
+    // xorshift: priorities only have to look random
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    Node &node = nodes[inner];
+    node.left = leafFirst ? leaf : neighbour;
+    node.right = leafFirst ? neighbour : leaf;
+    node.parent = parent;
+    node.first = node.last = NONE;
+    node.priority = seed;
+    node.stale = true;
+    nodes[leaf].parent = nodes[neighbour].parent = inner;
+
+    if (parent == NONE)
+        root = inner;
+    else if (nodes[parent].left == neighbour)
+        nodes[parent].left = inner;
+    else
+        nodes[parent].right = inner;
+
+    while (nodes[inner].parent != NONE && nodes[nodes[inner].parent].priority < nodes[inner].priority)
+        rotateUp(inner);
+    touch(inner);
+}
+
+void DynamicConvexHull::unlink(uint32_t leaf)
+{
+    uint32_t parent = nodes[leaf].parent;
+    if (parent == NONE)
+    {
+        root = NONE;
+        return;
+    }
+
+    uint32_t
+            sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left,
+            grand = nodes[parent].parent;
+    nodes[sibling].parent = grand;
+    if (grand == NONE)
+        root = sibling;
+    else if (nodes[grand].left == parent)
+        nodes[grand].left = sibling;
+    else
+        nodes[grand].right = sibling;
+    freeNodes.push_back(parent);
+
+    if (grand != NONE)
+        touch(grand);
+}
+
+void DynamicConvexHull::rotateUp(uint32_t node)
+{
+    uint32_t
+            parent = nodes[node].parent,
+            grand = nodes[parent].parent;
+
+    if (nodes[parent].left == node)
+    {
+        nodes[parent].left = nodes[node].right;
+        nodes[nodes[node].right].parent = parent;
+        nodes[node].right = parent;
+    }
+    else
+    {
+        nodes[parent].right = nodes[node].left;
+        nodes[nodes[node].left].parent = parent;
+        nodes[node].left = parent;
+    }
+    nodes[parent].parent = node;
+    nodes[node].parent = grand;
+
+    if (grand == NONE)
+        root = node;
+    else if (nodes[grand].left == parent)
+        nodes[grand].left = node;
+    else
+        nodes[grand].right = node;
+
+    // parent is below node now, touch of node does not reach it
+    Node &lowered = nodes[parent];
+    lowered.first = nodes[lowered.left].first;
+    lowered.last = nodes[lowered.right].last;
+    lowered.stale = true;
+}
+
+void DynamicConvexHull::touch(uint32_t node)
+{
+    // ancestors of stale node are stale: stop once nothing else changes
+    for (; node != NONE; node = nodes[node].parent)
+    {
+        Node &inner = nodes[node];
+        uint32_t
+                first = nodes[inner.left].first,
+                last = nodes[inner.right].last;
+        if (inner.stale && inner.first == first && inner.last == last)
+            break;
+        inner.first = first;
+        inner.last = last;
+        inner.stale = true;
+    }
+}
+
+void DynamicConvexHull::refresh(uint32_t node)
+{
+    if (isLeaf(node) || !nodes[node].stale)
+        return;
+
+    refresh(nodes[node].left);
+    refresh(nodes[node].right);
+    findBridge(node, UPPER);
+    findBridge(node, LOWER);
+    nodes[node].stale = false;
+}
+
+void DynamicConvexHull::findBridge(uint32_t node, Chain chain)
+{
+    /*
+     * Upper bridge of left subtree hull A and right one B, lower chain is the
+     * same search with subtrees swapped in the plane rotated by 180 degrees:
+     * rotation keeps orientations and reverses lexicographic order.
+     * Each step takes an edge of A (a0, a1) and of B (b0, b1) and drops half
+     * of at least one hull:
+     *  - point of B on or above line a0 a1: bridge end in A is at most a0;
+     *  - point of A on or above line b0 b1: bridge end in B is at least b1;
+     *  - otherwise lines a and b cross, on the B side of it a is above b and
+     *    all B is below a, so a is a hull edge and bridge end in A is at least
+     *    a1; on the A side all A is below b and bridge end in B is at most b0.
+     * A hull reduced to one vertex is the bridge end, the other one is then
+     * found as tangent from it.
+     */
+    bool upper = chain == UPPER;
+    Node const &parent = nodes[node];
+    uint32_t minB = upper ? nodes[parent.right].first : nodes[parent.left].last;
+    Cursor
+            a{upper ? parent.left : parent.right, NONE, NONE},
+            b{upper ? parent.right : parent.left, NONE, NONE};
+
+    for (;;)
+    {
+        normalize(a, chain);
+        normalize(b, chain);
+        bool aLeaf = isLeaf(a.node), bLeaf = isLeaf(b.node);
+        if (aLeaf && bLeaf)
+            break;
+
+        uint32_t a0 = NONE, a1 = NONE, b0 = NONE, b1 = NONE;
+        if (!aLeaf)
+        {
+            a0 = nodes[a.node].bridge[chain][upper ? 0 : 1];
+            a1 = nodes[a.node].bridge[chain][upper ? 1 : 0];
+        }
+        if (!bLeaf)
+        {
+            b0 = nodes[b.node].bridge[chain][upper ? 0 : 1];
+            b1 = nodes[b.node].bridge[chain][upper ? 1 : 0];
+        }
+
+        // -1: bridge end goes before edge, 1: after it, 0: unknown
+        int moveA = 0, moveB = 0;
+        if (aLeaf)
+            moveB = orient(b0, b1, a.node) >= 0 ? 1 : -1;
+        else if (bLeaf)
+            moveA = orient(a0, a1, b.node) >= 0 ? -1 : 1;
+        else
+        {
+            if (orient(a0, a1, b0) >= 0 || orient(a0, a1, b1) >= 0)
+                moveA = -1;
+            if (orient(b0, b1, a0) >= 0 || orient(b0, b1, a1) >= 0)
+                moveB = 1;
+            if (!moveA && !moveB)
+            {
+                Vector const
+                        &pa0 = nodes[a0].point, &pa1 = nodes[a1].point,
+                        &pb0 = nodes[b0].point, &pb1 = nodes[b1].point;
+                // b is never vertical here: points of A left of it are above;
+                // vertical a is a hull edge unless B reaches its line
+                if (pa0.x() == pa1.x())
+                    moveA = nodes[minB].point.x() == pa0.x() ? -1 : 1;
+                else
+                {
+                    double s = upper ? 1 : -1;
+                    HeightDifference difference{
+                        s * pa0.x(), s * pa0.y(), s * pa1.x(), s * pa1.y(),
+                        s * pb0.x(), s * pb0.y(), s * pb1.x(), s * pb1.y(),
+                        s * nodes[minB].point.x()};
+                    if (exactSign(difference) > 0)
+                        moveA = 1;
+                    else
+                        moveB = -1;
+                }
+            }
+        }
+
+        if (moveA < 0)
+        {
+            a.hi = a0;
+            a.node = upper ? nodes[a.node].left : nodes[a.node].right;
+        }
+        else if (moveA > 0)
+        {
+            a.lo = a1;
+            a.node = upper ? nodes[a.node].right : nodes[a.node].left;
+        }
+        if (moveB < 0)
+        {
+            b.hi = b0;
+            b.node = upper ? nodes[b.node].left : nodes[b.node].right;
+        }
+        else if (moveB > 0)
+        {
+            b.lo = b1;
+            b.node = upper ? nodes[b.node].right : nodes[b.node].left;
+        }
+    }
+
+    nodes[node].bridge[chain][upper ? 0 : 1] = a.node;
+    nodes[node].bridge[chain][upper ? 1 : 0] = b.node;
+}
+
+void DynamicConvexHull::normalize(Cursor &cursor, Chain chain) const
+{
+    bool upper = chain == UPPER;
+    while (!isLeaf(cursor.node))
+    {
+        Node const &node = nodes[cursor.node];
+        uint32_t
+                first = node.bridge[chain][upper ? 0 : 1],
+                second = node.bridge[chain][upper ? 1 : 0];
+        // window vertices are vertices of this subtree hull as well
+        if (cursor.hi != NONE && before(cursor.hi, second, chain))
+            cursor.node = upper ? node.left : node.right;
+        else if (cursor.lo != NONE && before(first, cursor.lo, chain))
+            cursor.node = upper ? node.right : node.left;
+        else
+            break;
+    }
+}
+
+void DynamicConvexHull::collect(uint32_t node, Chain chain, uint32_t lo, uint32_t hi, std::vector<uint32_t> &out) const
+{
+    // lo and hi are hull vertices of the subtree, so range is never empty
+    if (isLeaf(node))
+    {
+        out.push_back(node);
+        return;
+    }
+
+    Node const &inner = nodes[node];
+    uint32_t
+            left = inner.bridge[chain][0],
+            right = inner.bridge[chain][1];
+    if (!before(left, lo, UPPER))
+        collect(inner.left, chain, lo, before(hi, left, UPPER) ? hi : left, out);
+    if (!before(hi, right, UPPER))
+        collect(inner.right, chain, before(lo, right, UPPER) ? right : lo, hi, out);
+}
+
+void DynamicConvexHull::addToChain(uint32_t leaf, Chain chain, Update *update)
+{
+    ChainSet &vertices = chains[chain];
+    int sign = chain == UPPER ? -1 : 1;
+    auto convex = [&]( uint32_t a, uint32_t b, uint32_t c ) {
+        return sign * orient(a, b, c) > 0;
+    };
+
+    auto next = vertices.lower_bound(leaf);
+    if (next != vertices.begin() && next != vertices.end() &&
+        !convex(*std::prev(next), leaf, *next))
+        return;
+
+    std::vector<uint32_t> removedBefore, removedAfter;
+    while (next != vertices.begin())
+    {
+        auto prev = std::prev(next);
+        if (prev == vertices.begin() || convex(*std::prev(prev), *prev, leaf))
+            break;
+        removedBefore.push_back(*prev);
+        vertices.erase(prev);
+    }
+    while (next != vertices.end())
+    {
+        auto after = std::next(next);
+        if (after == vertices.end() || convex(leaf, *next, *after))
+            break;
+        removedAfter.push_back(*next);
+        next = vertices.erase(next);
+    }
+
+    if (update)
+    {
+        std::vector<Vector> before, after;
+        if (next != vertices.begin())
+        {
+            before.push_back(nodes[*std::prev(next)].point);
+            after.push_back(before.back());
+        }
+        for (auto it = removedBefore.rbegin(); it != removedBefore.rend(); ++it)
+            before.push_back(nodes[*it].point);
+        for (uint32_t removed : removedAfter)
+            before.push_back(nodes[removed].point);
+        after.push_back(nodes[leaf].point);
+        if (next != vertices.end())
+        {
+            before.push_back(nodes[*next].point);
+            after.push_back(before.back());
+        }
+        report(chain, before, after, update);
+    }
+    vertices.insert(next, leaf);
+}
+
+void DynamicConvexHull::removeFromChain(uint32_t leaf, Chain chain, Update *update)
+{
+    ChainSet &vertices = chains[chain];
+    auto it = vertices.find(leaf);
+    if (it == vertices.end())
+        return;
+
+    // neighbours stay hull vertices, vertices between them come from tree
+    uint32_t
+            prev = it != vertices.begin() ? *std::prev(it) : NONE,
+            next = std::next(it) != vertices.end() ? *std::next(it) : NONE;
+    auto hint = vertices.erase(it);
+
+    std::vector<uint32_t> uncovered;
+    if (root != NONE)
+    {
+        refresh(root);
+        collect(root, chain, prev != NONE ? prev : nodes[root].first,
+                next != NONE ? next : nodes[root].last, uncovered);
+    }
+    for (uint32_t vertex : uncovered)
+        if (vertex != prev && vertex != next)
+            vertices.insert(hint, vertex);
+
+    if (update)
+    {
+        std::vector<Vector> before, after;
+        if (prev != NONE)
+            before.push_back(nodes[prev].point);
+        before.push_back(nodes[leaf].point);
+        if (next != NONE)
+            before.push_back(nodes[next].point);
+        for (uint32_t vertex : uncovered)
+            after.push_back(nodes[vertex].point);
+        report(chain, before, after, update);
+    }
+}
+
+void DynamicConvexHull::report(Chain chain, const std::vector<Vector> &before,
+                               const std::vector<Vector> &after, Update *update) const
+{
+    // lower chain goes counterclockwise from left to right, upper one back
+    auto edges = [chain]( std::vector<Vector> const &part, std::vector<Edge> &out ) {
+        for (size_t i = 1; i < part.size(); i++)
+            out.push_back(chain == LOWER ? Edge(part[i - 1], part[i]) : Edge(part[i], part[i - 1]));
+    };
+    edges(before, update->removed);
+    edges(after, update->added);
+}
+
+void DynamicConvexHull::reportRepresentative(uint32_t leaf, const Vector &previous, Update *update) const
+{
+    if (!update)
+        return;
+
+    for (int chain = UPPER; chain <= LOWER; chain++)
+    {
+        ChainSet const &vertices = chains[chain];
+        auto it = vertices.find(leaf);
+        if (it == vertices.end())
+            continue;
+
+        std::vector<Vector> before, after;
+        if (it != vertices.begin())
+            before.push_back(nodes[*std::prev(it)].point);
+        before.push_back(previous);
+        if (std::next(it) != vertices.end())
+            before.push_back(nodes[*std::next(it)].point);
+        after = before;
+        std::replace_if(after.begin(), after.end(), [&]( Vector const &p ) {
+            return p == previous;
+        }, nodes[leaf].point);
+        report(static_cast<Chain>(chain), before, after, update);
+    }
+}
+
+bool DynamicConvexHull::before(uint32_t lhs, uint32_t rhs, Chain chain) const
+{
+    return chain == UPPER ? nodes[lhs].point < nodes[rhs].point : nodes[rhs].point < nodes[lhs].point;
+}
+
+int DynamicConvexHull::orient(uint32_t a, uint32_t b, uint32_t c) const
+{
+    Vector const &pa = nodes[a].point, &pb = nodes[b].point, &pc = nodes[c].point;
+    auto turn = Predicates::orient2d(pa.x(), pa.y(), pb.x(), pb.y(), pc.x(), pc.y());
+    return (turn > 0) - (turn < 0);
+}
@@ -0,0 +1,236 @@
+#ifndef DYNAMIC_CONVEX_HULL_H
+#define DYNAMIC_CONVEX_HULL_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+#include "primitives.h"
+#include "convex_hull_graham.h"
+
+/*!
+ * \brief The DynamicConvexHull class
+ * \details Convex hull of a point set under insertions and deletions.
+ * \details Points live at the leaves of a treap ordered lexicographically,
+ * \details each inner node keeps the bridges joining upper and lower hulls
+ * \details of its subtrees (Overmars and van Leeuwen). Hull vertices are also
+ * \details kept as two explicit chains, so insertion costs amortized
+ * \details O(log n): it updates chains and only marks bridges on its path
+ * \details stale. Bridges are recomputed, O(log n) per stale node, when a
+ * \details hull vertex is deleted and the chain between its neighbours has
+ * \details to be read from the tree. Other deletions cost O(log n).
+ * \details Equal points are kept once, the smallest id represents them.
+ */
+class DynamicConvexHull
+{
+public:
+    //! Hull edge, ends in counterclockwise order
+    using Edge = std::pair<Vector, Vector>;
+
+    /*!
+     * \brief The Update struct
+     * \details Hull edges removed and added by one operation.
+     */
+    struct Update
+    {
+        std::vector<Edge> removed, added;
+    };
+
+    /*!
+     * \brief Class constructor.
+     */
+    DynamicConvexHull();
+
+    DynamicConvexHull( DynamicConvexHull const & ) = delete;
+    DynamicConvexHull & operator=( DynamicConvexHull const & ) = delete;
+
+    /*!
+     * \brief Insert point function.
+     * \param point Point.
+     * \param update[OUT] Hull edges changed, may be nullptr.
+     */
+    void insert( Vector const &point, Update *update = nullptr );
+
+    /*!
+     * \brief Erase point function.
+     * \param point Point, coordinates and id must match inserted one.
+     * \param update[OUT] Hull edges changed, may be nullptr.
+     * \return false if point was not inserted.
+     */
+    bool erase( Vector const &point, Update *update = nullptr );
+
+    /*!
+     * \brief Get convex hull function.
+     * \details Vertices go counterclockwise from lexicographically smallest
+     * \details one, collinear points are dropped as ConvexHullGraham does.
+     * \return Ordered points of convex hull.
+     */
+    ConvexHullGraham::Hull hull() const;
+
+    /*!
+     * \brief Get number of points function.
+     * \return Number of points, equal ones counted separately.
+     */
+    size_t size() const;
+
+private:
+    //! Upper and lower chain indices
+    enum Chain { UPPER = 0, LOWER = 1 };
+
+    static const uint32_t NONE;
+
+    /*!
+     * \brief The Node struct
+     * \details Treap node. Leaves hold points, inner nodes have both children
+     * \details and bridges given as leaves: bridge[chain][0] is in left
+     * \details subtree, bridge[chain][1] is in right one.
+     */
+    struct Node
+    {
+        uint32_t left, right, parent;
+        uint32_t first, last;
+        uint32_t bridge[2][2];
+        uint32_t priority;
+        bool stale;
+        Vector point;
+    };
+
+    /*!
+     * \brief The Cursor struct
+     * \details Position of bridge search in hull of a subtree: node and
+     * \details window of hull vertices still possible, NONE if unbounded.
+     */
+    struct Cursor
+    {
+        uint32_t node, lo, hi;
+    };
+
+    /*!
+     * \brief The LeafLess struct
+     * \details Lexicographic order of leaves.
+     */
+    struct LeafLess
+    {
+        std::vector<Node> const *nodes;
+
+        bool operator()( uint32_t lhs, uint32_t rhs ) const;
+    };
+
+    using ChainSet = std::set<uint32_t, LeafLess>;
+
+    /*!
+     * \brief Check node is leaf function.
+     */
+    bool isLeaf( uint32_t node ) const;
+
+    /*!
+     * \brief Allocate node function.
+     * \return Node index.
+     */
+    uint32_t allocate();
+
+    /*!
+     * \brief Insert leaf into treap function.
+     * \param leaf Leaf, its point not yet in treap.
+     * \param neighbour Leaf next to new one in order, NONE if tree is empty.
+     */
+    void link( uint32_t leaf, uint32_t neighbour );
+
+    /*!
+     * \brief Remove leaf from treap function.
+     * \param leaf Leaf.
+     */
+    void unlink( uint32_t leaf );
+
+    /*!
+     * \brief Rotate inner node above its parent function.
+     * \param node Node.
+     */
+    void rotateUp( uint32_t node );
+
+    /*!
+     * \brief Mark bridges stale up to root function.
+     * \details Also refreshes first and last leaves of subtrees.
+     * \param node Lowest changed node.
+     */
+    void touch( uint32_t node );
+
+    /*!
+     * \brief Recompute stale bridges in subtree function.
+     * \param node Subtree root.
+     */
+    void refresh( uint32_t node );
+
+    /*!
+     * \brief Find bridge of node children function.
+     * \details Simultaneous descent over implicit hulls of both children,
+     * \details lower chain is searched in the plane rotated by 180 degrees.
+     * \param node Inner node with up to date children.
+     * \param chain Chain.
+     */
+    void findBridge( uint32_t node, Chain chain );
+
+    /*!
+     * \brief Descend cursor until its bridge lies in window function.
+     */
+    void normalize( Cursor &cursor, Chain chain ) const;
+
+    /*!
+     * \brief Collect chain vertices in lexicographic range function.
+     * \param node Subtree root.
+     * \param chain Chain.
+     * \param lo First leaf of range.
+     * \param hi Last leaf of range.
+     * \param out[OUT] Leaves, ascending.
+     */
+    void collect( uint32_t node, Chain chain, uint32_t lo, uint32_t hi, std::vector<uint32_t> &out ) const;
+
+    /*!
+     * \brief Add leaf to explicit chain function.
+     */
+    void addToChain( uint32_t leaf, Chain chain, Update *update );
+
+    /*!
+     * \brief Remove leaf from explicit chain function.
+     * \details Vertices uncovered are read from the tree.
+     */
+    void removeFromChain( uint32_t leaf, Chain chain, Update *update );
+
+    /*!
+     * \brief Report edges of changed chain part function.
+     * \param chain Chain.
+     * \param before Chain part before change, ascending.
+     * \param after Chain part after change, ascending.
+     * \param update[OUT] Update, may be nullptr.
+     */
+    void report( Chain chain, std::vector<Vector> const &before,
+                 std::vector<Vector> const &after, Update *update ) const;
+
+    /*!
+     * \brief Report edges at leaf whose representative changed function.
+     */
+    void reportRepresentative( uint32_t leaf, Vector const &previous, Update *update ) const;
+
+    /*!
+     * \brief Compare leaves in chain search order function.
+     * \return true if lhs goes before rhs.
+     */
+    bool before( uint32_t lhs, uint32_t rhs, Chain chain ) const;
+
+    /*!
+     * \brief Orientation sign of three leaves function.
+     */
+    int orient( uint32_t a, uint32_t b, uint32_t c ) const;
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> freeNodes;
+    uint32_t root;
+    uint32_t seed;
+    size_t count;
+    //! Points by coordinates: leaf and ids of equal points but its own
+    std::map<std::pair<Coord, Coord>, std::pair<uint32_t, std::vector<int>>> points;
+    ChainSet chains[2];
+};
+
+#endif // DYNAMIC_CONVEX_HULL_H
@@ -1,67 +1,154 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdlib>
 #include <string>
 
 #include "point_loader.h"
 #include "convex_hull_graham.h"
 #include "minimal_support_line.h"
+#include "support_line_tracker.h"
+#include "nearest_edge_query.h"
+#include "thread_pool.h"
+#include "stats.h"
 
 using namespace std;
 
 void help()
 {
-    std::clog << "Usage: -i path/to/input/file [-o path/to/output/file]\n";
+    std::clog << "Usage: -i path/to/input/file [-o path/to/output/file] [-t threads] [-s]\n"
+                 "       [-w] [-q path/to/query/file] [--stats]\n"
+                 "  -t  number of threads, 0 -- all cores (default 1)\n"
+                 "  -s  stream points one by one through incremental tracker\n"
+                 "  -w  weight mass center by fourth input column, which must be present\n"
+                 "      (not with -s)\n"
+                 "  -q  find nearest hull edge line of every query point, one line\n"
+                 "      \"query_id id1 id2\" per point goes to output file\n"
+                 "  --stats  print phase times, counters and peak memory as JSON to stderr\n";
 }
 
 int main( int argc, char *argv[] )
 {
-    if (argc != 5 && argc != 3)
+    if (argc < 3)
     {
         help();
         return 0;
     }
 
-    std::string inputFileName, outputFileName;
+    std::string inputFileName, outputFileName, queryFileName;
     std::ostream *os = &std::cout;
     std::ofstream ofs;
-    for (int i = 1; i < argc; i += 2)
-        if (!strcmp(argv[i], "-i"))
-            inputFileName = argv[i + 1];
-        else if (!strcmp(argv[i], "-o"))
+    unsigned threads = 1;
+    bool stream = false, weighted = false, printStats = false;
+    for (int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            inputFileName = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
         {
-            ofs = std::ofstream(argv[i + 1]);
+            ofs = std::ofstream(argv[++i]);
 
             if (!ofs)
             {
-                std::clog << "file " << argv[i + 1] << " not found\n";
+                std::clog << "file " << argv[i] << " not found\n";
             }
             os = &ofs;
         }
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-s"))
+            stream = true;
+        else if (!strcmp(argv[i], "-w"))
+            weighted = true;
+        else if (!strcmp(argv[i], "-q") && i + 1 < argc)
+            queryFileName = argv[++i];
+        else if (!strcmp(argv[i], "--stats"))
+            printStats = true;
         else
         {
             help();
-            break;
+            return 0;
         }
 
+    if (weighted && stream)
+    {
+        std::clog << "-w can not be used with -s\n";
+        return 0;
+    }
 
+    // reports after pool is joined
+    Stats::Report report(printStats ? &std::clog : nullptr);
+    ThreadPool pool(threads);
     PointLoader loader;
 
     bool ok;
-    auto points = loader.loadFromFile(inputFileName, &ok);
+    auto points = loader.loadFromFile(inputFileName, &ok, &pool);
     if (!ok)
     {
         std::clog << "Something went wrong while loading input file\n";
         return 0;
     }
+    if (points.empty())
+    {
+        std::clog << "input file has no points\n";
+        return 0;
+    }
+    if (weighted && !points.weighted())
+    {
+        std::clog << "-w needs weight column in input file\n";
+        return 0;
+    }
 
-    ConvexHullGraham ch(points);
-    auto hull = ch.buildConvexHull();
+    std::pair<int, int> optline;
+    ConvexHullGraham::Hull hull;
+    if (stream)
+    {
+        SupportLineTracker tracker;
+        {
+            STATS_PHASE("stream_insert");
+            for (size_t i = 0; i < points.size(); i++)
+                tracker.insert(points[i]);
+        }
+        {
+            STATS_PHASE("support_line_search");
+            optline = tracker.findMinimalSupportLine();
+        }
+        if (!queryFileName.empty())
+            hull = tracker.convexHull().hull();
+    }
+    else
+    {
+        ConvexHullGraham ch(points, &pool);
+        hull = ch.buildConvexHull();
 
-    MinimalSupportLine msl;
-    auto optline = msl.findMinimalSupportLine(points, hull);
+        MinimalSupportLine msl(&pool, weighted);
+        optline = msl.findMinimalSupportLine(points, hull);
+    }
 
     std::cout << "Optimal line contains points with id " <<
                  optline.first << " and id " << optline.second << "\n";
+
+    if (!queryFileName.empty())
+    {
+        auto queries = loader.loadFromFile(queryFileName, &ok, &pool);
+        if (!ok)
+        {
+            std::clog << "Something went wrong while loading query file\n";
+            return 0;
+        }
+
+        std::vector<uint32_t> edges;
+        NearestEdgeQuery query(hull, true);
+        {
+            STATS_PHASE("query");
+            query.nearestEdges(queries, edges, &pool);
+        }
+
+        STATS_PHASE("output");
+        for (size_t i = 0; i < queries.size(); i++)
+        {
+            auto ids = query.edgeIds(edges[i]);
+            *os << queries.id()[i] << ' ' << ids.first << ' ' << ids.second << '\n';
+        }
+    }
     return 0;
 }
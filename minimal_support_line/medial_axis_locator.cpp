@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <queue>
+#include "medial_axis_locator.h"
+#include "predicates.h"
+
+const uint32_t MedialAxisLocator::NONE = UINT32_MAX;
+
+namespace
+{
+
+bool lexLess( double ax, double ay, double bx, double by )
+{
+    return ax < bx || (ax == bx && ay < by);
+}
+
+} // namespace
+
+bool MedialAxisLocator::Event::operator<(const Event &rhs) const
+{
+    if (x != rhs.x)
+        return x < rhs.x;
+    if (y != rhs.y)
+        return y < rhs.y;
+    // segments ending at a point leave before ones starting there come
+    return start < rhs.start;
+}
+
+bool MedialAxisLocator::Collapse::operator>(const Collapse &rhs) const
+{
+    if (time != rhs.time)
+        return time > rhs.time;
+    return edge > rhs.edge;
+}
+
+bool MedialAxisLocator::SegmentLess::operator()(uint32_t lhs, uint32_t rhs) const
+{
+    if (lhs == rhs)
+        return false;
+    if (lhs == NONE)
+    {
+        Segment const &s = locator->segments[rhs];
+        return Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, point[0], point[1]) < 0;
+    }
+    if (rhs == NONE)
+    {
+        // point on a segment belongs to the face above it
+        Segment const &s = locator->segments[lhs];
+        return Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, point[0], point[1]) >= 0;
+    }
+    return locator->below(lhs, rhs);
+}
+
+MedialAxisLocator::MedialAxisLocator(const ConvexHullGraham::Hull &hull) : planar(false)
+{
+    uint32_t h = static_cast<uint32_t>(hull.size());
+    if (h < 3)
+        return;
+
+    nx.resize(h);
+    ny.resize(h);
+    offset.resize(h);
+    for (uint32_t i = 0; i < h; i++)
+    {
+        double
+                x0 = hull[i].x(), y0 = hull[i].y(),
+                x1 = hull[(i + 1) % h].x(), y1 = hull[(i + 1) % h].y(),
+                len = std::hypot(x1 - x0, y1 - y0);
+        nx[i] = (y0 - y1) / len;
+        ny[i] = (x1 - x0) / len;
+        offset[i] = nx[i] * x0 + ny[i] * y0;
+        addSegment(x0, y0, x1, y1, i, NONE);
+    }
+
+    /* Shrink the polygon. Edges are kept in a circular list, start[i] is the
+     * point where the vertex between edge i and the next one started from:
+     * polygon vertex or point where an edge between them has vanished. */
+    std::vector<uint32_t> prev(h), next(h), stamp(h, 0);
+    std::vector<double> startX(h), startY(h);
+    for (uint32_t i = 0; i < h; i++)
+    {
+        prev[i] = (i + h - 1) % h;
+        next[i] = (i + 1) % h;
+        startX[i] = hull[next[i]].x();
+        startY[i] = hull[next[i]].y();
+    }
+
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> queue;
+    auto schedule = [&]( uint32_t i )
+    {
+        Collapse c;
+        stamp[i]++;
+        if (!collapse(prev[i], i, next[i], c))
+            return;
+        c.edge = i;
+        c.stamp = stamp[i];
+        queue.push(c);
+    };
+    for (uint32_t i = 0; i < h; i++)
+        schedule(i);
+
+    for (uint32_t alive = h; alive > 2;)
+    {
+        if (queue.empty())
+            return;
+        Collapse c = queue.top();
+        queue.pop();
+        if (c.stamp != stamp[c.edge])
+            continue;
+
+        uint32_t i = c.edge, p = prev[i], n = next[i];
+        addArc(startX[p], startY[p], c.x, c.y, p, i);
+        addArc(startX[i], startY[i], c.x, c.y, i, n);
+        next[p] = n;
+        prev[n] = p;
+        startX[p] = c.x;
+        startY[p] = c.y;
+        stamp[i]++;
+
+        if (--alive == 2)
+            addArc(startX[p], startY[p], startX[n], startY[n], p, n);
+        else
+        {
+            schedule(p);
+            schedule(n);
+        }
+    }
+
+    for (uint32_t s = 0; s < segments.size(); s++)
+    {
+        Segment const &segment = segments[s];
+        events.push_back(Event{segment.lx, segment.ly, s, true});
+        events.push_back(Event{segment.rx, segment.ry, s, false});
+    }
+    std::sort(events.begin(), events.end());
+    planar = checkPlanar();
+}
+
+bool MedialAxisLocator::valid() const
+{
+    return planar;
+}
+
+void MedialAxisLocator::locate(Coord const *x, Coord const *y, uint32_t const *order, size_t n,
+                               uint32_t *edge) const
+{
+    if (!n)
+        return;
+
+    double point[2] = {static_cast<double>(x[order[0]]), static_cast<double>(y[order[0]])};
+    Status status(SegmentLess{this, point});
+
+    // start the sweep at the first point: events up to it are done
+    Event probe{point[0], point[1], 0, true};
+    size_t e = std::upper_bound(events.begin(), events.end(), probe) - events.begin();
+    for (uint32_t s = 0; s < segments.size(); s++)
+    {
+        Segment const &segment = segments[s];
+        if (!lexLess(point[0], point[1], segment.lx, segment.ly) &&
+                lexLess(point[0], point[1], segment.rx, segment.ry))
+            status.insert(s);
+    }
+
+    for (size_t k = 0; k < n; k++)
+    {
+        uint32_t i = order[k];
+        point[0] = x[i];
+        point[1] = y[i];
+        for (; e < events.size() && !lexLess(point[0], point[1], events[e].x, events[e].y); e++)
+            apply(events[e], status, false);
+
+        auto upper = status.lower_bound(NONE);
+        if (upper == status.begin() || segments[*std::prev(upper)].above == NONE)
+        {
+            edge[i] = NONE;
+            continue;
+        }
+
+        // arc ends are rounded: the point may be just across one of the
+        // segments around it, compare with faces there
+        Segment const &lower = segments[*std::prev(upper)];
+        uint32_t face = lower.above, candidates[3] = {lower.below, NONE, NONE};
+        if (upper != status.end())
+        {
+            candidates[1] = segments[*upper].below;
+            candidates[2] = segments[*upper].above;
+        }
+        double best = distance(point[0], point[1], face);
+        for (uint32_t c : candidates)
+        {
+            if (c == NONE || c == face)
+                continue;
+            double dist = distance(point[0], point[1], c);
+            if (dist < best || (dist == best && c < face))
+            {
+                best = dist;
+                face = c;
+            }
+        }
+        edge[i] = face;
+    }
+}
+
+bool MedialAxisLocator::collapse(uint32_t prev, uint32_t edge, uint32_t next, Collapse &collapse) const
+{
+    /* offset lines n.q = offset + t of three edges meet at the point where
+     * the middle one vanishes: differences of equations give a 2x2 system */
+    double
+            ax = nx[edge] - nx[prev], ay = ny[edge] - ny[prev],
+            bx = nx[next] - nx[edge], by = ny[next] - ny[edge],
+            ra = offset[edge] - offset[prev],
+            rb = offset[next] - offset[edge],
+            det = ax * by - ay * bx;
+    if (det == 0 || !std::isfinite(det))
+        return false;
+
+    collapse.x = (ra * by - ay * rb) / det;
+    collapse.y = (ax * rb - ra * bx) / det;
+    collapse.time = distance(collapse.x, collapse.y, edge);
+    return std::isfinite(collapse.time);
+}
+
+void MedialAxisLocator::addSegment(double ax, double ay, double bx, double by, uint32_t left, uint32_t right)
+{
+    // going left to right, left side is above
+    if (lexLess(ax, ay, bx, by))
+        segments.push_back(Segment{ax, ay, bx, by, left, right});
+    else
+        segments.push_back(Segment{bx, by, ax, ay, right, left});
+}
+
+void MedialAxisLocator::addArc(double ax, double ay, double bx, double by, uint32_t f, uint32_t g)
+{
+    if (ax == bx && ay == by)
+        return;
+
+    // arc lies on the bisector of edge lines: f is to the left if its
+    // distance grows slower going left
+    double
+            lx = ay - by, ly = bx - ax,
+            side = (nx[f] - nx[g]) * lx + (ny[f] - ny[g]) * ly;
+    if (side < 0)
+        addSegment(ax, ay, bx, by, f, g);
+    else
+        addSegment(ax, ay, bx, by, g, f);
+}
+
+bool MedialAxisLocator::checkPlanar() const
+{
+    Status status(SegmentLess{this, nullptr});
+    for (Event const &event : events)
+        if (!apply(event, status, true))
+            return false;
+    return status.empty();
+}
+
+bool MedialAxisLocator::below(uint32_t lhs, uint32_t rhs) const
+{
+    Segment const &s = segments[lhs], &t = segments[rhs];
+    if (s.lx == t.lx && s.ly == t.ly)
+        return Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, t.rx, t.ry) > 0;
+
+    // compare at the later left end, then at the other segment right end
+    if (lexLess(t.lx, t.ly, s.lx, s.ly))
+    {
+        double o = Predicates::orient2d(t.lx, t.ly, t.rx, t.ry, s.lx, s.ly);
+        if (o == 0)
+            o = Predicates::orient2d(t.lx, t.ly, t.rx, t.ry, s.rx, s.ry);
+        return o < 0;
+    }
+    double o = Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, t.lx, t.ly);
+    if (o == 0)
+        o = Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, t.rx, t.ry);
+    return o > 0;
+}
+
+bool MedialAxisLocator::interfere(uint32_t lhs, uint32_t rhs) const
+{
+    Segment const &s = segments[lhs], &t = segments[rhs];
+    double
+            o1 = Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, t.lx, t.ly),
+            o2 = Predicates::orient2d(s.lx, s.ly, s.rx, s.ry, t.rx, t.ry),
+            o3 = Predicates::orient2d(t.lx, t.ly, t.rx, t.ry, s.lx, s.ly),
+            o4 = Predicates::orient2d(t.lx, t.ly, t.rx, t.ry, s.rx, s.ry);
+    if (((o1 < 0 && o2 > 0) || (o1 > 0 && o2 < 0)) && ((o3 < 0 && o4 > 0) || (o3 > 0 && o4 < 0)))
+        return true;
+
+    // an end lying inside the other segment
+    auto inside = []( double px, double py, Segment const &segment )
+    {
+        return lexLess(segment.lx, segment.ly, px, py) && lexLess(px, py, segment.rx, segment.ry);
+    };
+    return (o1 == 0 && inside(t.lx, t.ly, s)) || (o2 == 0 && inside(t.rx, t.ry, s)) ||
+            (o3 == 0 && inside(s.lx, s.ly, t)) || (o4 == 0 && inside(s.rx, s.ry, t));
+}
+
+bool MedialAxisLocator::apply(const Event &event, Status &status, bool check) const
+{
+    if (event.start)
+    {
+        auto inserted = status.insert(event.segment);
+        if (!inserted.second)
+            return false;
+        if (!check)
+            return true;
+        auto it = inserted.first, after = std::next(it);
+        return (it == status.begin() || !interfere(*std::prev(it), *it)) &&
+                (after == status.end() || !interfere(*it, *after));
+    }
+
+    auto it = status.find(event.segment);
+    if (it == status.end() || *it != event.segment)
+        return false;
+    it = status.erase(it);
+    return !check || it == status.begin() || it == status.end() || !interfere(*std::prev(it), *it);
+}
+
+double MedialAxisLocator::distance(double x, double y, uint32_t edge) const
+{
+    return nx[edge] * x + ny[edge] * y - offset[edge];
+}
@@ -0,0 +1,166 @@
+#ifndef MEDIAL_AXIS_LOCATOR_H
+#define MEDIAL_AXIS_LOCATOR_H
+
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "primitives.h"
+#include "convex_hull_graham.h"
+
+/*!
+ * \brief The MedialAxisLocator class
+ * \details Nearest edge line of points inside a convex polygon. There it is
+ * \details the medial axis face the point lies in. Medial axis is built by
+ * \details shrinking the polygon: edges move inwards at unit speed and
+ * \details vanish one by one, O(h log h). Faces are located by a sweep over
+ * \details medial axis arcs and polygon edges, a sorted batch of points costs
+ * \details O(log h) per point plus one pass over the arcs.
+ * \details Arc ends are rounded, so the subdivision is checked to be planar
+ * \details once. The locator is not valid if it is not.
+ */
+class MedialAxisLocator
+{
+public:
+    //! No edge: point is outside the polygon
+    static const uint32_t NONE;
+
+    /*!
+     * \brief Class constructor.
+     * \param hull Convex polygon, counterclockwise without collinear vertices.
+     * \details Edge i goes from vertex i to vertex i + 1.
+     */
+    explicit MedialAxisLocator( ConvexHullGraham::Hull const &hull );
+
+    MedialAxisLocator( MedialAxisLocator const & ) = delete;
+    MedialAxisLocator & operator=( MedialAxisLocator const & ) = delete;
+
+    /*!
+     * \brief Check locator can be used function.
+     * \return false if polygon is degenerate or subdivision is not planar.
+     */
+    bool valid() const;
+
+    /*!
+     * \brief Locate points function.
+     * \details Locator must be valid. May be called concurrently.
+     * \param x x coordinates.
+     * \param y y coordinates.
+     * \param order Indices of points to locate, lexicographically ascending.
+     * \param n Number of indices.
+     * \param edge[OUT] Nearest edge line by point index, NONE if outside.
+     */
+    void locate( Coord const *x, Coord const *y, uint32_t const *order, size_t n,
+                 uint32_t *edge ) const;
+
+private:
+    /*!
+     * \brief The Segment struct
+     * \details Medial axis arc or polygon edge, ends lexicographically
+     * \details ascending, faces on both sides.
+     */
+    struct Segment
+    {
+        double lx, ly, rx, ry;
+        uint32_t above, below;
+    };
+
+    /*!
+     * \brief The Event struct
+     * \details Sweep event: segment starts or ends at its point.
+     */
+    struct Event
+    {
+        double x, y;
+        uint32_t segment;
+        bool start;
+
+        bool operator<( Event const &rhs ) const;
+    };
+
+    /*!
+     * \brief The Collapse struct
+     * \details Moment shrinking edge vanishes, point it vanishes at.
+     */
+    struct Collapse
+    {
+        double time, x, y;
+        uint32_t edge, stamp;
+
+        bool operator>( Collapse const &rhs ) const;
+    };
+
+    /*!
+     * \brief The SegmentLess struct
+     * \details Bottom to top order of segments crossed by sweep line. Index
+     * \details NONE stands for the point being located.
+     */
+    struct SegmentLess
+    {
+        MedialAxisLocator const *locator;
+        double const *point;
+
+        bool operator()( uint32_t lhs, uint32_t rhs ) const;
+    };
+
+    using Status = std::set<uint32_t, SegmentLess>;
+
+    /*!
+     * \brief Find moment edge vanishes between its neighbours function.
+     * \param collapse[OUT] Time and point, edge and stamp are not set.
+     * \return false if edge lines are degenerate.
+     */
+    bool collapse( uint32_t prev, uint32_t edge, uint32_t next, Collapse &collapse ) const;
+
+    /*!
+     * \brief Add segment function.
+     * \param left Face to the left of a to b direction.
+     * \param right Face to the right of it.
+     */
+    void addSegment( double ax, double ay, double bx, double by, uint32_t left, uint32_t right );
+
+    /*!
+     * \brief Add medial axis arc function.
+     * \details Zero length arcs are dropped.
+     * \param f One face, side is found from edge lines.
+     * \param g Other face.
+     */
+    void addArc( double ax, double ay, double bx, double by, uint32_t f, uint32_t g );
+
+    /*!
+     * \brief Check planarity function.
+     * \details Sweep checking segments that become neighbours do not cross.
+     */
+    bool checkPlanar() const;
+
+    /*!
+     * \brief Compare segments crossed by one vertical line function.
+     * \return true if lhs goes below rhs.
+     */
+    bool below( uint32_t lhs, uint32_t rhs ) const;
+
+    /*!
+     * \brief Check segments cross or touch not at common end function.
+     */
+    bool interfere( uint32_t lhs, uint32_t rhs ) const;
+
+    /*!
+     * \brief Apply sweep event function.
+     * \param check Check segments that become neighbours.
+     * \return false if status is inconsistent or check fails.
+     */
+    bool apply( Event const &event, Status &status, bool check ) const;
+
+    /*!
+     * \brief Get signed distance of point to edge line function.
+     * \return Distance, positive inside.
+     */
+    double distance( double x, double y, uint32_t edge ) const;
+
+    //! Inward unit normals and offsets of edge lines
+    std::vector<double> nx, ny, offset;
+    std::vector<Segment> segments;
+    std::vector<Event> events;
+    bool planar;
+};
+
+#endif // MEDIAL_AXIS_LOCATOR_H
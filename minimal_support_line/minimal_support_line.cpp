@@ -1,51 +1,118 @@
-#include <limits>
+#include <algorithm>
 #include "minimal_support_line.h"
+#include "compensated_sum.h"
+#include "nearest_edge_query.h"
+#include "stats.h"
 
-std::pair<int, int> MinimalSupportLine::findMinimalSupportLine(
-        const std::vector<Vector> &points,
-        const std::list<Vector> &conv_hull)
+const size_t MinimalSupportLine::blockSize = 1 << 16;
+
+namespace
 {
-    auto massCenter = findMassCenter(points);
 
-    int opt_id1, opt_id2;
-    double opt_dist = std::numeric_limits<double>::max();
+//! Independent sums per coordinate
+const size_t lanes = 4;
 
-    int i = 0;
-    for (auto it = conv_hull.begin(); it != conv_hull.end(); ++it, i++)
-    {
-        auto it1 = it;
-        auto it2 = it;
-        ++it2;
-        it2 = it2 != conv_hull.end() ? it2 : conv_hull.begin();
-        auto line = getCanonicalLine(*it1, *it2);
-        auto dist = massCenter.distToLine(line);
-
-        if (dist < opt_dist)
+/*!
+ * \brief The BlockSums struct
+ * \details Sums of x, y and weight over a block with their compensations.
+ */
+struct BlockSums
+{
+    double sum[3][lanes], compensation[3][lanes];
+};
+
+/*!
+ * \brief Sum block of points function.
+ * \details Lanes take every fourth point, so they have no dependency on
+ * \details each other and the loop runs in vector registers.
+ */
+template<bool Weighted>
+void sumBlock( Coord const *x, Coord const *y, double const *w, size_t first, size_t last,
+               BlockSums &sums )
+{
+    // local arrays stay in registers, members of a struct do not
+    double sum[3][lanes] = {}, compensation[3][lanes] = {};
+    size_t i = first;
+    for (; i + lanes <= last; i += lanes)
+        for (size_t l = 0; l < lanes; l++)
         {
-            opt_id1 = it1->id();
-            opt_id2 = it2->id();
-            opt_dist = dist;
+            double wi = Weighted ? w[i + l] : 1;
+            CompensatedSum::twoSum(sum[0][l], compensation[0][l], wi * x[i + l]);
+            CompensatedSum::twoSum(sum[1][l], compensation[1][l], wi * y[i + l]);
+            if (Weighted)
+                CompensatedSum::twoSum(sum[2][l], compensation[2][l], wi);
         }
+    for (; i < last; i++)
+    {
+        double wi = Weighted ? w[i] : 1;
+        CompensatedSum::twoSum(sum[0][0], compensation[0][0], wi * x[i]);
+        CompensatedSum::twoSum(sum[1][0], compensation[1][0], wi * y[i]);
+        if (Weighted)
+            CompensatedSum::twoSum(sum[2][0], compensation[2][0], wi);
     }
-    return {opt_id1, opt_id2};
+    std::copy(&sum[0][0], &sum[0][0] + 3 * lanes, &sums.sum[0][0]);
+    std::copy(&compensation[0][0], &compensation[0][0] + 3 * lanes, &sums.compensation[0][0]);
+}
+
+} // namespace
+
+MinimalSupportLine::MinimalSupportLine( ThreadPool *pool, bool weighted ) :
+    pool(pool), weighted(weighted)
+{}
+
+std::pair<int, int> MinimalSupportLine::findMinimalSupportLine(
+        const PointSet &points,
+        const ConvexHullGraham::Hull &conv_hull)
+{
+    STATS_PHASE("support_line_search");
+    NearestEdgeQuery query(conv_hull);
+    return query.edgeIds(query.nearestEdge(findMassCenter(points)));
 }
 
 std::tuple<double, double, double>
 MinimalSupportLine::getCanonicalLine( Vector const &p0, Vector const &p1 )
 {
-    return std::make_tuple(
-                p1.y() - p0.y(),
-                p0.x() - p1.x(),
-                p1.x() * p0.y() - p1.y() * p0.x());
+    double
+            x0 = p0.x(), y0 = p0.y(),
+            x1 = p1.x(), y1 = p1.y();
+    return std::make_tuple(y1 - y0, x0 - x1, x1 * y0 - y1 * x0);
 }
 
-Vector MinimalSupportLine::findMassCenter(
-        const std::vector<Vector> &points ) const
+BasicVector<double> MinimalSupportLine::findMassCenter( PointSet const &points ) const
 {
-    Vector res;
+    size_t
+            n = points.size(),
+            blocks = (n + blockSize - 1) / blockSize;
+    Coord const
+            *x = points.x().data(),
+            *y = points.y().data();
+    double const *w = weighted && points.weighted() ? points.weight().data() : nullptr;
+
+    std::vector<BlockSums> partial(blocks);
+    auto sum = [&]( size_t block )
+    {
+        size_t first = block * blockSize, last = std::min(n, first + blockSize);
+        if (w != nullptr)
+            sumBlock<true>(x, y, w, first, last, partial[block]);
+        else
+            sumBlock<false>(x, y, w, first, last, partial[block]);
+    };
+
+    if (pool != nullptr && pool->size() > 1 && blocks > 1)
+        pool->run(blocks, sum);
+    else
+        for (size_t b = 0; b < blocks; b++)
+            sum(b);
 
-    for (auto &pt : points)
-        res += pt;
+    CompensatedSum total[3];
+    for (auto const &part : partial)
+        for (int k = 0; k < 3; k++)
+            for (size_t l = 0; l < lanes; l++)
+            {
+                total[k].add(part.sum[k][l]);
+                total[k].add(part.compensation[k][l]);
+            }
 
-    return res / points.size();
+    double mass = w != nullptr ? total[2].value() : static_cast<double>(n);
+    return BasicVector<double>(total[0].value() / mass, total[1].value() / mass);
 }
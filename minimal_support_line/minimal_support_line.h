@@ -1,38 +1,58 @@
 #ifndef MINIMAL_SUPPORT_LINE_H
 #define MINIMAL_SUPPORT_LINE_H
 
-#include <list>
 #include <vector>
 #include <tuple>
 #include "primitives.h"
+#include "point_set.h"
+#include "convex_hull_graham.h"
+#include "thread_pool.h"
 
 class MinimalSupportLine
 {
 public:
+    /*!
+     * \brief Class constructor.
+     * \param pool Thread pool to find mass center on, may be nullptr.
+     * \param weighted Weight points in mass center if set carries weights.
+     */
+    explicit MinimalSupportLine( ThreadPool *pool = nullptr, bool weighted = false );
+
     /*!
      * \brief Find minimal support line function.
      * \param points Point to build minimial support line to.
      * \param conv_hull Convex hull of point set.
-     * \return
+     * \return Identifiers of the optimal hull edge ends.
      */
     std::pair<int, int> findMinimalSupportLine(
-            std::vector<Vector> const &points,
-            std::list<Vector> const &conv_hull );
+            PointSet const &points,
+            ConvexHullGraham::Hull const &conv_hull );
 
-private:
     /*!
      * \brief Get canonical line parameters function.
      * \param p0 First point in line.
      * \param p1 Second point in line.
      * \return a, b, c: ax + by + c = 0.
      */
-    std::tuple<double, double, double> getCanonicalLine( Vector const &p0, Vector const &p1 );
+    static std::tuple<double, double, double> getCanonicalLine( Vector const &p0, Vector const &p1 );
 
     /*!
      * \brief Find mass center function.
+     * \details Points are summed in fixed size blocks, four compensated sums
+     * \details per coordinate in each, and blocks are added up in order, so
+     * \details result does not depend on number of threads. Weighted sums
+     * \details and sum of weights are taken in the same pass.
+     * \param points Points, not empty.
      * \return Mass center of point set.
      */
-    Vector findMassCenter(const std::vector<Vector> &points) const;
+    BasicVector<double> findMassCenter( PointSet const &points ) const;
+
+private:
+    //! Points per block of mass center sums
+    static const size_t blockSize;
+
+    ThreadPool *pool;
+    bool weighted;
 };
 
 #endif // MINIMAL_SUPPORT_LINE_H
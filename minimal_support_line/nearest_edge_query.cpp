@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include "nearest_edge_query.h"
+#include "minimal_support_line.h"
+
+const size_t NearestEdgeQuery::blockSize;
+const size_t NearestEdgeQuery::locateThreshold = 256;
+
+NearestEdgeQuery::NearestEdgeQuery(const ConvexHullGraham::Hull &hull, bool locate)
+{
+    size_t h = hull.size();
+    a.resize(h);
+    b.resize(h);
+    c.resize(h);
+    norm.resize(h);
+    ids.resize(h);
+    for (size_t i = 0; i < h; i++)
+    {
+        auto line = MinimalSupportLine::getCanonicalLine(hull[i], hull[i + 1 < h ? i + 1 : 0]);
+        a[i] = std::get<0>(line);
+        b[i] = std::get<1>(line);
+        c[i] = std::get<2>(line);
+        norm[i] = std::sqrt(a[i] * a[i] + b[i] * b[i]);
+        ids[i] = hull[i].id();
+    }
+
+    if (locate && h >= locateThreshold)
+    {
+        locator.reset(new MedialAxisLocator(hull));
+        if (!locator->valid())
+            locator.reset();
+    }
+}
+
+size_t NearestEdgeQuery::size() const
+{
+    return ids.size();
+}
+
+std::pair<int, int> NearestEdgeQuery::edgeIds(size_t edge) const
+{
+    return {ids[edge], ids[edge + 1 < ids.size() ? edge + 1 : 0]};
+}
+
+size_t NearestEdgeQuery::nearestEdge(const BasicVector<double> &point) const
+{
+    size_t opt = 0;
+    double optDist = std::numeric_limits<double>::max();
+    for (size_t k = 0; k < a.size(); k++)
+    {
+        double dist = std::abs(a[k] * point.x() + b[k] * point.y() + c[k]) / norm[k];
+        if (dist < optDist)
+        {
+            opt = k;
+            optDist = dist;
+        }
+    }
+    return opt;
+}
+
+void NearestEdgeQuery::nearestEdges(const PointSet &points, std::vector<uint32_t> &edges,
+                                    ThreadPool *pool) const
+{
+    size_t n = points.size();
+    edges.assign(n, 0);
+    if (!n || ids.empty())
+        return;
+
+    size_t chunks = pool != nullptr && pool->size() > 1 ? pool->size() : 1;
+    auto run = [&]( std::function<void( size_t )> const &task )
+    {
+        if (chunks > 1)
+            pool->run(chunks, task);
+        else
+            task(0);
+    };
+
+    if (!locator)
+    {
+        run([&]( size_t k )
+        {
+            scan(points, nullptr, n * k / chunks, n * (k + 1) / chunks, edges.data());
+        });
+        return;
+    }
+
+    // points are located by a sweep, each chunk sweeps its own part of plane
+    Coord const
+            *x = points.x().data(),
+            *y = points.y().data();
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [x, y]( uint32_t lhs, uint32_t rhs )
+    {
+        return x[lhs] < x[rhs] || (x[lhs] == x[rhs] && y[lhs] < y[rhs]);
+    });
+    run([&]( size_t k )
+    {
+        size_t first = n * k / chunks, last = n * (k + 1) / chunks;
+        locator->locate(x, y, order.data() + first, last - first, edges.data());
+    });
+
+    std::vector<uint32_t> outside;
+    for (size_t i = 0; i < n; i++)
+        if (edges[i] == MedialAxisLocator::NONE)
+            outside.push_back(static_cast<uint32_t>(i));
+    size_t m = outside.size();
+    run([&]( size_t k )
+    {
+        scan(points, outside.data(), m * k / chunks, m * (k + 1) / chunks, edges.data());
+    });
+}
+
+void NearestEdgeQuery::scan(double const *x, double const *y, uint32_t *edge) const
+{
+    double best[blockSize], opt[blockSize];
+    for (size_t j = 0; j < blockSize; j++)
+    {
+        best[j] = std::numeric_limits<double>::max();
+        opt[j] = 0;
+    }
+
+    /* Fixed number of points and no branches, so the inner loop vectorizes.
+     * Edge index is blended arithmetically: a second select on the same
+     * comparison keeps the compiler from if-converting the loop. */
+    for (size_t k = 0; k < a.size(); k++)
+    {
+        double ak = a[k], bk = b[k], ck = c[k], nk = norm[k], e = static_cast<double>(k);
+        for (size_t j = 0; j < blockSize; j++)
+        {
+            double
+                    dist = std::abs(ak * x[j] + bk * y[j] + ck) / nk,
+                    closer = dist < best[j];
+            best[j] = dist < best[j] ? dist : best[j];
+            opt[j] += (e - opt[j]) * closer;
+        }
+    }
+
+    for (size_t j = 0; j < blockSize; j++)
+        edge[j] = static_cast<uint32_t>(opt[j]);
+}
+
+void NearestEdgeQuery::scan(const PointSet &points, uint32_t const *indices, size_t first, size_t last,
+                            uint32_t *edges) const
+{
+    Coord const
+            *px = points.x().data(),
+            *py = points.y().data();
+    double x[blockSize], y[blockSize];
+    uint32_t edge[blockSize];
+
+    for (size_t i = first; i < last; i += blockSize)
+    {
+        // last block is padded with copies of its last point
+        size_t m = std::min(blockSize, last - i);
+        for (size_t j = 0; j < blockSize; j++)
+        {
+            size_t p = i + std::min(j, m - 1);
+            if (indices != nullptr)
+                p = indices[p];
+            x[j] = px[p];
+            y[j] = py[p];
+        }
+
+        scan(x, y, edge);
+        for (size_t j = 0; j < m; j++)
+            edges[indices != nullptr ? indices[i + j] : i + j] = edge[j];
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef NEAREST_EDGE_QUERY_H
+#define NEAREST_EDGE_QUERY_H
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "primitives.h"
+#include "point_set.h"
+#include "convex_hull_graham.h"
+#include "medial_axis_locator.h"
+#include "thread_pool.h"
+
+/*!
+ * \brief The NearestEdgeQuery class
+ * \details Minimal support line queries against one convex hull: hull edge
+ * \details whose line is nearest to the query point. Edge lines are computed
+ * \details once and kept as arrays of coefficients and norms, so distances
+ * \details are the same MinimalSupportLine gets. Query points are scanned
+ * \details against all lines in blocks, loops are kept simple for the
+ * \details compiler to vectorize them.
+ * \details For large hulls points inside are located in the medial axis
+ * \details instead, O(log h) per point (see MedialAxisLocator). Distances
+ * \details there are not computed the same way, so edges whose lines are at
+ * \details equal distance up to rounding may be chosen differently.
+ */
+class NearestEdgeQuery
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param hull Convex hull, counterclockwise.
+     * \details Edge i goes from vertex i to vertex i + 1.
+     * \param locate Build medial axis locator if hull is large enough.
+     */
+    explicit NearestEdgeQuery( ConvexHullGraham::Hull const &hull, bool locate = false );
+
+    /*!
+     * \brief Get number of edges function.
+     * \return Number of edges.
+     */
+    size_t size() const;
+
+    /*!
+     * \brief Get edge ends function.
+     * \param edge Edge index.
+     * \return Identifiers of edge ends.
+     */
+    std::pair<int, int> edgeIds( size_t edge ) const;
+
+    /*!
+     * \brief Find nearest edge line function.
+     * \details Scans all edges, first one of equally near is returned.
+     * \param point Query point.
+     * \return Edge index.
+     */
+    size_t nearestEdge( BasicVector<double> const &point ) const;
+
+    /*!
+     * \brief Find nearest edge lines of many points function.
+     * \param points Query points.
+     * \param edges[OUT] Edge index by point index.
+     * \param pool Thread pool to split points over, may be nullptr.
+     */
+    void nearestEdges( PointSet const &points, std::vector<uint32_t> &edges,
+                       ThreadPool *pool = nullptr ) const;
+
+private:
+    //! Points scanned at once
+    static const size_t blockSize = 64;
+    //! Least number of edges medial axis locator is built for
+    static const size_t locateThreshold;
+
+    /*!
+     * \brief Scan block of points function.
+     * \param x x coordinates, blockSize of them.
+     * \param y y coordinates, blockSize of them.
+     * \param edge[OUT] Nearest edge line of every point.
+     */
+    void scan( double const *x, double const *y, uint32_t *edge ) const;
+
+    /*!
+     * \brief Scan points function.
+     * \param points Query points.
+     * \param indices Indices of points to scan, nullptr for all ones.
+     * \param first First index position.
+     * \param last Position past last one.
+     * \param edges[OUT] Edge index by point index.
+     */
+    void scan( PointSet const &points, uint32_t const *indices, size_t first, size_t last,
+               uint32_t *edges ) const;
+
+    //! Edge lines ax + by + c = 0 and norms of (a, b)
+    PointSet::Array<double> a, b, c, norm;
+    //! Hull vertex identifiers
+    std::vector<int> ids;
+    std::unique_ptr<MedialAxisLocator> locator;
+};
+
+#endif // NEAREST_EDGE_QUERY_H
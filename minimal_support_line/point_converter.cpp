@@ -0,0 +1,58 @@
+#include <iostream>
+#include <cstring>
+#include <string>
+
+#include "point_loader.h"
+#include "point_writer.h"
+
+void help()
+{
+    std::clog << "Usage: -i path/to/input/file -o path/to/output/file [-f text|binary]\n"
+                 "  converts between text and binary point files,\n"
+                 "  by default to the format opposite to the input one\n";
+}
+
+int main( int argc, char *argv[] )
+{
+    std::string inputFileName, outputFileName, format;
+    for (int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            inputFileName = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+            outputFileName = argv[++i];
+        else if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            format = argv[++i];
+        else
+        {
+            help();
+            return 0;
+        }
+
+    if (inputFileName.empty() || outputFileName.empty() ||
+        !(format.empty() || format == "text" || format == "binary"))
+    {
+        help();
+        return 0;
+    }
+
+    if (format.empty())
+        format = PointLoader::isBinaryFile(inputFileName) ? "text" : "binary";
+
+    bool ok;
+    auto points = PointLoader::loadFromFile(inputFileName, &ok);
+    if (!ok)
+    {
+        std::clog << "Something went wrong while loading input file\n";
+        return 1;
+    }
+
+    ok = format == "binary" ?
+                PointWriter::saveBinary(outputFileName, points) :
+                PointWriter::saveText(outputFileName, points);
+    if (!ok)
+    {
+        std::clog << "Something went wrong while writing output file\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "point_generator.h"
+
+PointGenerator::PointGenerator( uint64_t seed ) : engine(seed) {}
+
+PointSet PointGenerator::uniform( std::size_t n, double range )
+{
+    PointSet points;
+    points.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        coordinate((2 * real() - 1) * range, points.x()[i]);
+        coordinate((2 * real() - 1) * range, points.y()[i]);
+    }
+    shuffle(points);
+    return points;
+}
+
+PointSet PointGenerator::clusters( std::size_t n, std::size_t clusters, double range, double sigma )
+{
+    std::vector<std::pair<double, double>> centers(clusters);
+    for (auto &c : centers)
+        c = std::make_pair((2 * real() - 1) * range, (2 * real() - 1) * range);
+
+    PointSet points;
+    points.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        auto &c = centers[i % clusters];
+        coordinate(c.first + sigma * normal(), points.x()[i]);
+        coordinate(c.second + sigma * normal(), points.y()[i]);
+    }
+    shuffle(points);
+    return points;
+}
+
+PointSet PointGenerator::circle( std::size_t n, double radius )
+{
+    const double pi = std::acos(-1.0);
+
+    PointSet points;
+    points.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double angle = 2 * pi * static_cast<double>(i) / static_cast<double>(n);
+        coordinate(radius * std::cos(angle), points.x()[i]);
+        coordinate(radius * std::sin(angle), points.y()[i]);
+    }
+    shuffle(points);
+    return points;
+}
+
+PointSet PointGenerator::parabola( std::size_t n, bool *ok )
+{
+    bool fits = true;
+    PointSet points;
+    points.resize(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double x = static_cast<double>(i) - static_cast<double>(n / 2), y = x * x;
+        fits = fits && y < 9007199254740992.0 &&
+                coordinate(x, points.x()[i]) && coordinate(y, points.y()[i]) &&
+                static_cast<double>(points.y()[i]) == y;
+    }
+    shuffle(points);
+
+    if (ok)
+        *ok = fits;
+    return points;
+}
+
+double PointGenerator::real()
+{
+    // upper 53 bits of engine output
+    return static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+double PointGenerator::normal()
+{
+    // Box-Muller transform, 1 - u is in (0, 1]
+    const double pi = std::acos(-1.0);
+    double u = 1 - real(), v = real();
+    return std::sqrt(-2 * std::log(u)) * std::cos(2 * pi * v);
+}
+
+bool PointGenerator::coordinate( double value, Coord &coord )
+{
+    return toCoordinate(std::numeric_limits<Coord>::is_integer ? std::round(value) : value, coord);
+}
+
+void PointGenerator::shuffle( PointSet &points )
+{
+    // Fisher-Yates on own uniform numbers, not std::shuffle: its use of
+    // the engine is up to the library
+    auto &x = points.x();
+    auto &y = points.y();
+    for (std::size_t i = points.size(); i > 1; i--)
+    {
+        auto j = static_cast<std::size_t>(real() * static_cast<double>(i));
+        std::swap(x[i - 1], x[j]);
+        std::swap(y[i - 1], y[j]);
+    }
+    for (std::size_t i = 0; i < points.size(); i++)
+        points.id()[i] = static_cast<int>(i);
+}
@@ -0,0 +1,94 @@
+#ifndef POINT_GENERATOR_H
+#define POINT_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include "point_set.h"
+
+/*!
+ * \brief The PointGenerator class
+ * \details Seeded synthetic point sets for benchmarks. Random numbers are
+ * \details made from raw 64 bit engine output, so a seed gives the same
+ * \details points with any standard library. Coordinates are rounded for
+ * \details integer coordinate types. Points are shuffled, ids are 0..n-1
+ * \details in set order.
+ */
+class PointGenerator
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param seed Random seed.
+     */
+    explicit PointGenerator( uint64_t seed );
+
+    /*!
+     * \brief Uniform points function.
+     * \param n Number of points.
+     * \param range Points are in square [-range, range]^2.
+     * \return Points.
+     */
+    PointSet uniform( std::size_t n, double range = 1e6 );
+
+    /*!
+     * \brief Gaussian clusters function.
+     * \details Centers are uniform in the square, points are spread
+     * \details around them by normal distribution.
+     * \param n Number of points.
+     * \param clusters Number of clusters.
+     * \param range Centers are in square [-range, range]^2.
+     * \param sigma Standard deviation of both coordinates.
+     * \return Points.
+     */
+    PointSet clusters( std::size_t n, std::size_t clusters = 16, double range = 1e6,
+                       double sigma = 1e4 );
+
+    /*!
+     * \brief Points on circle function.
+     * \details Every point is on the hull up to coordinate rounding.
+     * \param n Number of points.
+     * \param radius Circle radius.
+     * \return Points.
+     */
+    PointSet circle( std::size_t n, double radius = 1e9 );
+
+    /*!
+     * \brief Points on parabola function.
+     * \details Points (x, x^2) for integer x in [-n/2, n/2), every point is
+     * \details a hull vertex. Exact while x^2 fits coordinate type and
+     * \details 53 bit mantissa.
+     * \param n Number of points.
+     * \param ok[OUT] false if points do not fit coordinate type.
+     * \return Points.
+     */
+    PointSet parabola( std::size_t n, bool *ok = nullptr );
+
+private:
+    /*!
+     * \brief Get uniform number in [0, 1) function.
+     */
+    double real();
+
+    /*!
+     * \brief Get standard normal number function.
+     */
+    double normal();
+
+    /*!
+     * \brief Convert to coordinate function.
+     * \param value Value, rounded for integer coordinates.
+     * \param coord[OUT] Coordinate.
+     * \return false if value does not fit coordinate type.
+     */
+    static bool coordinate( double value, Coord &coord );
+
+    /*!
+     * \brief Shuffle points function.
+     */
+    void shuffle( PointSet &points );
+
+    std::mt19937_64 engine;
+};
+
+#endif // POINT_GENERATOR_H
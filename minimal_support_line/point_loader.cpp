@@ -1,14 +1,229 @@
-#include <fstream>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <string>
 
 #include "point_loader.h"
 #include "primitives.h"
+#include "mapped_file.h"
+#include "binary_format.h"
+#include "stats.h"
 
-std::vector<Vector> PointLoader::loadFromFile( std::string const& fileName, bool *ok )
+const size_t PointLoader::minChunkBytes = 1 << 20;
+
+static inline bool isBlank( char c )
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+static inline bool isDigit( char c )
+{
+    return c >= '0' && c <= '9';
+}
+
+static inline bool isTokenEnd( char const *p, char const *end )
+{
+    return p == end || *p == '\n' || isBlank(*p);
+}
+
+static inline char const * skipBlanks( char const *p, char const *end )
+{
+    while (p != end && isBlank(*p))
+        ++p;
+    return p;
+}
+
+static bool parseInt( char const *&p, char const *end, int &value )
+{
+    bool neg = false;
+    if (p != end && (*p == '+' || *p == '-'))
+        neg = *p++ == '-';
+
+    long long res = 0;
+    char const *digits = p;
+    while (p != end && isDigit(*p))
+    {
+        res = res * 10 + (*p++ - '0');
+        if (res > static_cast<long long>(INT_MAX) + 1)
+            return false;
+    }
+    if (p == digits || (!neg && res > INT_MAX))
+        return false;
+
+    value = static_cast<int>(neg ? -res : res);
+    return isTokenEnd(p, end);
+}
+
+/*!
+ * \brief Parse floating point number function.
+ * \details Up to 19 significant digits with a small decimal exponent are
+ * \details converted exactly (the mantissa and the power of ten are both
+ * \details representable, so one rounding gives the nearest double).
+ * \details Everything else goes to strtod.
+ */
+static bool parseDouble( char const *&p, char const *end, double &value )
+{
+    static const double pow10[] =
+    {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const int maxDigits = 19;
+
+    char const *start = p;
+    bool neg = false;
+    if (p != end && (*p == '+' || *p == '-'))
+        neg = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int digits = 0, exp10 = 0;
+    bool any = false, exact = true;
+
+    for (; p != end && isDigit(*p); ++p, any = true)
+        if (digits < maxDigits)
+        {
+            mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+            digits += mantissa != 0;
+        }
+        else
+        {
+            exp10++;
+            exact &= *p == '0';
+        }
+
+    if (p != end && *p == '.')
+    {
+        for (++p; p != end && isDigit(*p); ++p, any = true)
+        {
+            if (digits < maxDigits)
+            {
+                mantissa = mantissa * 10 + static_cast<unsigned>(*p - '0');
+                digits += mantissa != 0;
+                exp10--;
+            }
+            else
+            {
+                exact &= *p == '0';
+            }
+        }
+    }
+
+    if (!any)
+        return false;
+
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        ++p;
+        bool expNeg = false;
+        if (p != end && (*p == '+' || *p == '-'))
+            expNeg = *p++ == '-';
+        if (p == end || !isDigit(*p))
+            return false;
+        int e = 0;
+        for (; p != end && isDigit(*p); ++p)
+            e = std::min(e * 10 + (*p - '0'), 100000);
+        exp10 += expNeg ? -e : e;
+    }
+
+    if (!isTokenEnd(p, end))
+        return false;
+
+    if (exact && mantissa <= (uint64_t(1) << 53) && exp10 >= -22 && exp10 <= 22)
+    {
+        double m = static_cast<double>(mantissa);
+        value = exp10 >= 0 ? m * pow10[exp10] : m / pow10[-exp10];
+        if (neg)
+            value = -value;
+        return true;
+    }
+
+    // slow path: long mantissa or large exponent, tokens too long for
+    // buffer (long decimal expansions) are copied to heap
+    char buf[128];
+    size_t len = static_cast<size_t>(p - start);
+    if (len >= sizeof(buf))
+    {
+        value = std::strtod(std::string(start, len).c_str(), nullptr);
+        return true;
+    }
+    std::memcpy(buf, start, len);
+    buf[len] = 0;
+    value = std::strtod(buf, nullptr);
+    return true;
+}
+
+/*!
+ * \brief Parse one line function.
+ * \param p[IN, OUT] Line start, next line start on exit.
+ * \param weight[OUT] Weight, nullptr if records have no weight column.
+ * \details Integer builds reject coordinates that are not integer.
+ * \return 1 if record parsed, 0 if line is blank, -1 on format error.
+ */
+static int parseLine( char const *&p, char const *end, int &id, Coord &x, Coord &y,
+                      double *weight )
 {
-    std::ifstream ifs(fileName);
+    double value;
 
-    if (!ifs)
+    p = skipBlanks(p, end);
+    if (p == end || *p == '\n')
+    {
+        p += p != end;
+        return 0;
+    }
+
+    if (!parseInt(p, end, id))
+        return -1;
+    p = skipBlanks(p, end);
+    if (!parseDouble(p, end, value) || !toCoordinate(value, x))
+        return -1;
+    p = skipBlanks(p, end);
+    if (!parseDouble(p, end, value) || !toCoordinate(value, y))
+        return -1;
+    p = skipBlanks(p, end);
+    if (weight != nullptr)
+    {
+        if (!parseDouble(p, end, *weight))
+            return -1;
+        p = skipBlanks(p, end);
+    }
+
+    if (p != end && *p != '\n')
+        return -1;
+    p += p != end;
+    return 1;
+}
+
+/*!
+ * \brief Check records have weight column function.
+ * \details First record decides: it has four fields instead of three.
+ */
+static bool hasWeightColumn( char const *p, char const *end )
+{
+    p = skipBlanks(p, end);
+    while (p != end && *p == '\n')
+        p = skipBlanks(p + 1, end);
+
+    int fields = 0;
+    while (p != end && *p != '\n')
+    {
+        fields++;
+        while (!isTokenEnd(p, end))
+            ++p;
+        p = skipBlanks(p, end);
+    }
+    return fields == 4;
+}
+
+PointSet PointLoader::loadFromFile( std::string const& fileName, bool *ok, ThreadPool *pool )
+{
+    STATS_PHASE("load");
+    MappedFile file;
+
+    if (!file.open(fileName))
     {
         std::clog << "file " << fileName << " not found\n";
         if (ok)
@@ -16,25 +231,142 @@ std::vector<Vector> PointLoader::loadFromFile( std::string const& fileName, bool
         return {};
     }
 
-    std::vector<Vector> points;
+    if (BinaryFormat::isBinary(file.data(), file.size()))
+        return loadBinary(file, ok);
+
+    char const
+            *text = file.data(),
+            *textEnd = text + file.size();
+
+    // chunk boundaries are placed right after a line feed
+    size_t chunks = 1;
+    if (pool != nullptr && pool->size() > 1)
+        chunks = std::max<size_t>(1, std::min<size_t>(pool->size() * 4,
+                                                      file.size() / minChunkBytes));
+    std::vector<char const *> bounds(chunks + 1, textEnd);
+    bounds[0] = text;
+    for (size_t c = 1; c < chunks; c++)
+    {
+        char const *p = std::max(bounds[c - 1], text + file.size() * c / chunks);
+        char const *lf = static_cast<char const *>(
+                    std::memchr(p, '\n', static_cast<size_t>(textEnd - p)));
+        bounds[c] = lf != nullptr ? lf + 1 : textEnd;
+    }
+
+    auto forEachChunk = [&]( std::function<void( size_t )> const &body )
+    {
+        if (pool != nullptr && chunks > 1)
+            pool->run(chunks, body);
+        else
+            for (size_t c = 0; c < chunks; c++)
+                body(c);
+    };
+
+    // count lines to size output once
+    std::vector<size_t> first(chunks + 1, 0);
+    forEachChunk([&]( size_t c )
+    {
+        char const *b = bounds[c], *e = bounds[c + 1];
+        size_t lines = static_cast<size_t>(std::count(b, e, '\n'));
+        first[c + 1] = lines + (b != e && e[-1] != '\n');
+    });
+    for (size_t c = 0; c < chunks; c++)
+        first[c + 1] += first[c];
+
+    PointSet points;
+    points.setWeighted(hasWeightColumn(text, textEnd));
+    points.resize(first[chunks]);
 
-    while (ifs.peek() != EOF)
+    std::vector<size_t> parsed(chunks, 0);
+    std::vector<char> failed(chunks, 0);
+    forEachChunk([&]( size_t c )
     {
-        Vector pt;
+        Coord
+                *xs = points.x().data() + first[c],
+                *ys = points.y().data() + first[c];
+        int *ids = points.id().data() + first[c];
+        double *ws = points.weighted() ? points.weight().data() + first[c] : nullptr;
+        char const *p = bounds[c], *e = bounds[c + 1];
+        size_t n = 0;
 
-        if (!(ifs >> pt))
+        while (p != e)
         {
-            if (ifs.peek() != EOF)
+            int res = parseLine(p, e, ids[n], xs[n], ys[n], ws != nullptr ? ws + n : nullptr);
+            if (res < 0)
             {
-                std::clog << "wrong file format\n";
-                if (ok)
-                    *ok = false;
-                return points;
+                failed[c] = 1;
+                break;
             }
+            n += static_cast<size_t>(res);
         }
-        else
-            points.emplace_back(pt);
+        parsed[c] = n;
+    });
+
+    // close gaps left by blank lines, stop at first broken chunk
+    size_t total = 0;
+    bool good = true;
+    for (size_t c = 0; c < chunks && good; c++)
+    {
+        if (total != first[c])
+        {
+            std::copy_n(points.x().begin() + first[c], parsed[c], points.x().begin() + total);
+            std::copy_n(points.y().begin() + first[c], parsed[c], points.y().begin() + total);
+            std::copy_n(points.id().begin() + first[c], parsed[c], points.id().begin() + total);
+            if (points.weighted())
+                std::copy_n(points.weight().begin() + first[c], parsed[c],
+                            points.weight().begin() + total);
+        }
+        total += parsed[c];
+        good = !failed[c];
     }
-    *ok = true;
+    points.resize(total);
+
+    if (!good)
+        std::clog << "wrong file format\n";
+    if (ok)
+        *ok = good;
+    return points;
+}
+
+bool PointLoader::isBinaryFile( std::string const& fileName )
+{
+    MappedFile file;
+    return file.open(fileName) && BinaryFormat::isBinary(file.data(), file.size());
+}
+
+PointSet PointLoader::loadBinary( MappedFile const &file, bool *ok )
+{
+    BinaryFormat::Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.version != BinaryFormat::version ||
+        header.type != BinaryFormat::Type::POINTS ||
+        BinaryFormat::scalarSize(header.scalar) == 0 ||
+        !isCoordinateScalar(header.scalar) ||
+        !BinaryFormat::fits(header, file.size()))
+    {
+        std::clog << "wrong file format\n";
+        if (ok)
+            *ok = false;
+        return {};
+    }
+
+    size_t n = static_cast<size_t>(header.count);
+    PointSet points;
+    points.setWeighted((header.flags & BinaryFormat::WEIGHTED) != 0);
+    points.resize(n);
+
+    std::memcpy(points.id().data(), file.data() + BinaryFormat::columnOffset(header, 0),
+                n * sizeof(int32_t));
+    BinaryFormat::readColumn(file.data() + BinaryFormat::columnOffset(header, 1),
+                             header.scalar, points.x().data(), n);
+    BinaryFormat::readColumn(file.data() + BinaryFormat::columnOffset(header, 2),
+                             header.scalar, points.y().data(), n);
+    if (points.weighted())
+        std::memcpy(points.weight().data(), file.data() + BinaryFormat::columnOffset(header, 3),
+                    n * sizeof(double));
+
+    if (ok)
+        *ok = true;
     return points;
 }
@@ -5,17 +5,49 @@
 #include <string>
 
 #include "primitives.h"
+#include "point_set.h"
+#include "thread_pool.h"
+
+class MappedFile;
 
 class PointLoader
 {
 public:
     /*!
      * \brief Load points from file function.
+     * \details Binary columnar files (see BinaryFormat) are detected by
+     * \details signature and copied column by column without parsing.
+     * \details Text files are memory mapped and parsed in place, one
+     * \details "id x y" record per line. Optional fourth column is point
+     * \details weight: if the first record has it, every one must.
+     * \details With a thread pool the file is split into
+     * \details chunks on line boundaries which are parsed concurrently.
      * \param fileName[IN] File name to load from.
      * \param ok[OUT] true if ok, false otherwise.
-     * \return List of segments.
+     * \param pool[IN] Thread pool to parse on, may be nullptr.
+     * \return Set of points.
      */
-    static std::vector<Vector> loadFromFile( std::string const& fileName, bool *ok=nullptr );
+    static PointSet loadFromFile( std::string const& fileName, bool *ok=nullptr,
+                                  ThreadPool *pool=nullptr );
+
+    /*!
+     * \brief Check if file is in binary columnar format function.
+     * \param fileName[IN] File name to check.
+     * \return true if binary, false otherwise.
+     */
+    static bool isBinaryFile( std::string const& fileName );
+
+private:
+    /*!
+     * \brief Load points from binary file function.
+     * \param file[IN] Mapped binary file.
+     * \param ok[OUT] true if ok, false otherwise.
+     * \return Set of points.
+     */
+    static PointSet loadBinary( MappedFile const &file, bool *ok );
+
+    //! Minimal chunk size in bytes for parallel parsing
+    static const size_t minChunkBytes;
 };
 
 #endif // SEGMENT_LOADER_H
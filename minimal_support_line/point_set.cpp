@@ -0,0 +1,115 @@
+#include "point_set.h"
+
+PointSet::PointSet() : _weighted(false) {}
+
+PointSet::PointSet( std::vector<Vector> const &points ) : _weighted(false)
+{
+    reserve(points.size());
+    for (auto &pt : points)
+        push_back(pt);
+}
+
+std::size_t PointSet::size() const
+{
+    return _x.size();
+}
+
+bool PointSet::empty() const
+{
+    return _x.empty();
+}
+
+void PointSet::reserve( std::size_t n )
+{
+    _x.reserve(n);
+    _y.reserve(n);
+    _id.reserve(n);
+    if (_weighted)
+        _weight.reserve(n);
+}
+
+void PointSet::resize( std::size_t n )
+{
+    _x.resize(n);
+    _y.resize(n);
+    _id.resize(n);
+    if (_weighted)
+        _weight.resize(n, 1);
+}
+
+bool PointSet::weighted() const
+{
+    return _weighted;
+}
+
+void PointSet::setWeighted( bool weighted )
+{
+    _weighted = weighted;
+    if (weighted)
+        _weight.resize(size(), 1);
+    else
+        Array<double>().swap(_weight);
+}
+
+void PointSet::push_back( Vector const &pt, double weight )
+{
+    _x.push_back(pt.x());
+    _y.push_back(pt.y());
+    _id.push_back(pt.id());
+    if (_weighted)
+        _weight.push_back(weight);
+}
+
+Vector PointSet::operator[]( std::size_t i ) const
+{
+    return Vector(_x[i], _y[i], _id[i]);
+}
+
+std::vector<Vector> PointSet::toVectors() const
+{
+    std::vector<Vector> points;
+    points.reserve(size());
+    for (std::size_t i = 0; i < size(); i++)
+        points.emplace_back(_x[i], _y[i], _id[i]);
+    return points;
+}
+
+PointSet::Array<Coord> & PointSet::x()
+{
+    return _x;
+}
+
+PointSet::Array<Coord> const & PointSet::x() const
+{
+    return _x;
+}
+
+PointSet::Array<Coord> & PointSet::y()
+{
+    return _y;
+}
+
+PointSet::Array<Coord> const & PointSet::y() const
+{
+    return _y;
+}
+
+PointSet::Array<int> & PointSet::id()
+{
+    return _id;
+}
+
+PointSet::Array<int> const & PointSet::id() const
+{
+    return _id;
+}
+
+PointSet::Array<double> & PointSet::weight()
+{
+    return _weight;
+}
+
+PointSet::Array<double> const & PointSet::weight() const
+{
+    return _weight;
+}
@@ -0,0 +1,156 @@
+#ifndef POINT_SET_H
+#define POINT_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include "primitives.h"
+
+/*!
+ * \brief The AlignedAllocator class
+ * \details Standard allocator returning memory aligned to Alignment bytes.
+ */
+template<class T, std::size_t Alignment>
+class AlignedAllocator
+{
+public:
+    using value_type = T;
+
+    template<class U>
+    struct rebind
+    {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() {}
+
+    template<class U>
+    AlignedAllocator( AlignedAllocator<U, Alignment> const & ) {}
+
+    T * allocate( std::size_t n )
+    {
+        // original pointer is kept right before the aligned block
+        std::size_t bytes = n * sizeof(T) + Alignment + sizeof(void *);
+        char *raw = static_cast<char *>(::operator new(bytes));
+        std::uintptr_t aligned =
+                (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *) + Alignment - 1) &
+                ~static_cast<std::uintptr_t>(Alignment - 1);
+        reinterpret_cast<void **>(aligned)[-1] = raw;
+        return reinterpret_cast<T *>(aligned);
+    }
+
+    void deallocate( T *p, std::size_t )
+    {
+        ::operator delete(reinterpret_cast<void **>(p)[-1]);
+    }
+
+    template<class U>
+    bool operator==( AlignedAllocator<U, Alignment> const & ) const { return true; }
+
+    template<class U>
+    bool operator!=( AlignedAllocator<U, Alignment> const & ) const { return false; }
+};
+
+/*!
+ * \brief The PointSet class
+ * \details Structure of arrays point storage: x, y and id live in separate
+ * \details arrays aligned for AVX loads, so hot loops read only coordinates.
+ * \details Weighted sets also carry a weight array.
+ */
+class PointSet
+{
+public:
+    //! Array alignment in bytes
+    static const std::size_t alignment = 64;
+
+    template<class T>
+    using Array = std::vector<T, AlignedAllocator<T, alignment>>;
+
+    /*!
+     * \brief Default class constructor.
+     */
+    PointSet();
+
+    /*!
+     * \brief Construct from point list function.
+     * \param points Points to copy.
+     */
+    explicit PointSet( std::vector<Vector> const &points );
+
+    /*!
+     * \brief Get number of points function.
+     * \return Number of points.
+     */
+    std::size_t size() const;
+
+    /*!
+     * \brief Check if set is empty function.
+     * \return true if empty, false otherwise.
+     */
+    bool empty() const;
+
+    /*!
+     * \brief Reserve storage function.
+     * \param n Number of points to reserve.
+     */
+    void reserve( std::size_t n );
+
+    /*!
+     * \brief Resize set function.
+     * \param n New number of points.
+     */
+    void resize( std::size_t n );
+
+    /*!
+     * \brief Check if set carries weights function.
+     * \return true if weighted, false otherwise.
+     */
+    bool weighted() const;
+
+    /*!
+     * \brief Set if set carries weights function.
+     * \details Points added to unweighted set get weight 1.
+     * \param weighted true to keep weights, false to drop them.
+     */
+    void setWeighted( bool weighted );
+
+    /*!
+     * \brief Append point function.
+     * \param pt Point to append.
+     * \param weight Point weight, ignored if set is not weighted.
+     */
+    void push_back( Vector const &pt, double weight = 1 );
+
+    /*!
+     * \brief Get point function.
+     * \param i Point index.
+     * \return Point.
+     */
+    Vector operator[]( std::size_t i ) const;
+
+    /*!
+     * \brief Get point list function.
+     * \return Array of structures copy of the set.
+     */
+    std::vector<Vector> toVectors() const;
+
+    /* Coordinate and id arrays */
+    Array<Coord> & x();
+    Array<Coord> const & x() const;
+    Array<Coord> & y();
+    Array<Coord> const & y() const;
+    Array<int> & id();
+    Array<int> const & id() const;
+    //! Weight array, empty if set is not weighted
+    Array<double> & weight();
+    Array<double> const & weight() const;
+
+private:
+    Array<Coord> _x, _y;
+    Array<int> _id;
+    Array<double> _weight;
+    bool _weighted;
+};
+
+#endif // POINT_SET_H
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include "point_writer.h"
+#include "binary_format.h"
+
+/*!
+ * \brief Format number to be read back exactly: %.15g, %.17g if it does not round-trip.
+ */
+static inline int formatExact( char *buf, size_t size, double value )
+{
+    int len = std::snprintf(buf, size, "%.15g", value);
+    if (std::strtod(buf, nullptr) != value)
+        len = std::snprintf(buf, size, "%.17g", value);
+    return len;
+}
+
+static inline int formatExact( char *buf, size_t size, int64_t value )
+{
+    return std::snprintf(buf, size, "%lld", static_cast<long long>(value));
+}
+
+static inline int formatExact( char *buf, size_t size, int32_t value )
+{
+    return formatExact(buf, size, int64_t(value));
+}
+
+bool PointWriter::saveText( std::string const &fileName, PointSet const &points )
+{
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+
+    std::vector<char> out;
+    out.reserve(1 << 20);
+    char buf[32];
+
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        int len = std::snprintf(buf, sizeof(buf), "%d ", points.id()[i]);
+        out.insert(out.end(), buf, buf + len);
+        len = formatExact(buf, sizeof(buf), points.x()[i]);
+        out.insert(out.end(), buf, buf + len);
+        out.push_back(' ');
+        len = formatExact(buf, sizeof(buf), points.y()[i]);
+        out.insert(out.end(), buf, buf + len);
+        if (points.weighted())
+        {
+            out.push_back(' ');
+            len = formatExact(buf, sizeof(buf), points.weight()[i]);
+            out.insert(out.end(), buf, buf + len);
+        }
+        out.push_back('\n');
+
+        if (out.size() >= (1 << 20))
+        {
+            ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+            out.clear();
+        }
+    }
+    ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(ofs);
+}
+
+bool PointWriter::saveBinary( std::string const &fileName, PointSet const &points )
+{
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+
+    auto header = BinaryFormat::makeHeader(BinaryFormat::Type::POINTS,
+                                           CoordinateTraits<Coord>::scalar(), points.size());
+    if (points.weighted())
+        header.flags |= BinaryFormat::WEIGHTED;
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        header.bbox[0] = std::min<double>(header.bbox[0], points.x()[i]);
+        header.bbox[1] = std::min<double>(header.bbox[1], points.y()[i]);
+        header.bbox[2] = std::max<double>(header.bbox[2], points.x()[i]);
+        header.bbox[3] = std::max<double>(header.bbox[3], points.y()[i]);
+    }
+
+    BinaryFormat::Writer writer(ofs);
+
+    size_t n = points.size();
+    writer.put(&header, 0, sizeof(header));
+    writer.put(points.id().data(), BinaryFormat::columnOffset(header, 0), n * sizeof(int32_t));
+    writer.put(points.x().data(), BinaryFormat::columnOffset(header, 1), n * sizeof(Coord));
+    writer.put(points.y().data(), BinaryFormat::columnOffset(header, 2), n * sizeof(Coord));
+    if (points.weighted())
+        writer.put(points.weight().data(), BinaryFormat::columnOffset(header, 3), n * sizeof(double));
+
+    return static_cast<bool>(ofs);
+}
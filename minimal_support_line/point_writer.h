@@ -0,0 +1,30 @@
+#ifndef POINT_WRITER_H
+#define POINT_WRITER_H
+
+#include <string>
+#include "point_set.h"
+
+class PointWriter
+{
+public:
+    /*!
+     * \brief Save points to text file function.
+     * \details One "id x y" record per line. Real coordinates are printed
+     * \details with %.15g, or with %.17g if that does not read back exactly.
+     * \details Weighted sets get weight as fourth column.
+     * \param fileName[IN] File name to write to.
+     * \param points[IN] Points to save.
+     * \return true if ok, false otherwise.
+     */
+    static bool saveText( std::string const &fileName, PointSet const &points );
+
+    /*!
+     * \brief Save points to binary columnar file function.
+     * \param fileName[IN] File name to write to.
+     * \param points[IN] Points to save.
+     * \return true if ok, false otherwise.
+     */
+    static bool saveBinary( std::string const &fileName, PointSet const &points );
+};
+
+#endif // POINT_WRITER_H
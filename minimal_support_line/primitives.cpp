@@ -2,50 +2,57 @@
 #include <tuple>
 #include "primitives.h"
 
-const double Vector::tolerance = 1e-5f;
-
-std::istream &operator>>(std::istream &is, Vector &pt)
+template<class T>
+std::istream &operator>>(std::istream &is, BasicVector<T> &pt)
 {
     int id;
-    double x, y;
+    T x, y;
     is >> id >> x >> y;
 
-    pt = Vector(x, y, id);
+    pt = BasicVector<T>(x, y, id);
     return is;
 }
 
-std::ostream & operator<<(std::ostream &os, Vector const &pt)
+template<class T>
+std::ostream & operator<<(std::ostream &os, BasicVector<T> const &pt)
 {
     os << pt.x() << ' ' << pt.y();
     return os;
 }
 
-Vector::Vector() : _x(0), _y(0) {}
+template<class T>
+BasicVector<T>::BasicVector() : _x(0), _y(0) {}
 
-double Vector::x() const
+template<class T>
+T BasicVector<T>::x() const
 {
     return _x;
 }
 
-double Vector::y() const
+template<class T>
+T BasicVector<T>::y() const
 {
     return _y;
 }
 
-int Vector::id() const
+template<class T>
+int BasicVector<T>::id() const
 {
     return _id;
 }
 
-double Vector::len2() const
+template<class T>
+typename CoordinateTraits<T>::Product BasicVector<T>::len2() const
 {
     return dotProd(*this);
 }
 
-Vector::Vector(double x, double y, int _id) : _id(_id), _x(x), _y(y)
+template<class T>
+BasicVector<T>::BasicVector(T x, T y, int _id) : _id(_id), _x(x), _y(y)
 {}
 
-Vector &Vector::operator+=(const Vector &rhs)
+template<class T>
+BasicVector<T> &BasicVector<T>::operator+=(const BasicVector &rhs)
 {
     _x += rhs._x;
     _y += rhs._y;
@@ -53,7 +60,8 @@ Vector &Vector::operator+=(const Vector &rhs)
     return *this;
 }
 
-Vector & Vector::operator=(const Vector &rhs)
+template<class T>
+BasicVector<T> & BasicVector<T>::operator=(const BasicVector &rhs)
 {
     _id = rhs._id;
     _x = rhs._x;
@@ -61,17 +69,20 @@ Vector & Vector::operator=(const Vector &rhs)
     return *this;
 }
 
-Vector Vector::operator-(const Vector &rhs) const
+template<class T>
+BasicVector<T> BasicVector<T>::operator-(const BasicVector &rhs) const
 {
-    return Vector(_x - rhs._x, _y - rhs._y);
+    return BasicVector(_x - rhs._x, _y - rhs._y);
 }
 
-Vector Vector::operator/(double num) const
+template<class T>
+BasicVector<T> BasicVector<T>::operator/(T num) const
 {
-    return Vector(_x / num, _y / num);
+    return BasicVector(_x / num, _y / num);
 }
 
-double Vector::distToLine(const std::tuple<double, double, double> &line) const
+template<class T>
+double BasicVector<T>::distToLine(const std::tuple<double, double, double> &line) const
 {
     double
             a = std::get<0>(line),
@@ -80,33 +91,49 @@ double Vector::distToLine(const std::tuple<double, double, double> &line) const
     return std::abs(a * _x + b * _y + c) / std::sqrt(a * a + b * b);
 }
 
-double Vector::crossProd(const Vector &rhs) const
+template<class T>
+typename CoordinateTraits<T>::Product BasicVector<T>::crossProd(const BasicVector &rhs) const
 {
-    return _x * rhs._y - rhs._x * _y;
+    using Product = typename CoordinateTraits<T>::Product;
+    return Product(_x) * rhs._y - Product(rhs._x) * _y;
 }
 
-double Vector::dotProd(const Vector &rhs) const
+template<class T>
+typename CoordinateTraits<T>::Product BasicVector<T>::dotProd(const BasicVector &rhs) const
 {
-    return _x * rhs._x + _y * rhs._y;
+    using Product = typename CoordinateTraits<T>::Product;
+    return Product(_x) * rhs._x + Product(_y) * rhs._y;
 }
 
-bool Vector::operator==(const Vector &rhs) const
+template<class T>
+bool BasicVector<T>::operator==(const BasicVector &rhs) const
 {
-    return
-            (rhs._x - _x) * (rhs._x - _x) +
-            (rhs._y - _y) * (rhs._y - _y) < tolerance;
+    return _x == rhs._x && _y == rhs._y;
 }
 
-bool Vector::operator<(const Vector &rhs) const
+template<class T>
+bool BasicVector<T>::operator<(const BasicVector &rhs) const
 {
-    if (_x + tolerance < rhs._x)
-        return true;
-    if (_x > rhs._x + tolerance)
-        return false;
-    return _y < rhs._y;
+    // exact lexicographic order: tolerance would break transitivity
+    return _x < rhs._x || (_x == rhs._x && _y < rhs._y);
 }
 
-bool Vector::operator<=(const Vector &rhs) const
+template<class T>
+bool BasicVector<T>::operator<=(const BasicVector &rhs) const
 {
     return *this < rhs || *this == rhs;
 }
+
+template class BasicVector<float>;
+template class BasicVector<double>;
+template class BasicVector<int32_t>;
+template class BasicVector<int64_t>;
+
+template std::istream & operator>>( std::istream &is, BasicVector<float> &pt );
+template std::istream & operator>>( std::istream &is, BasicVector<double> &pt );
+template std::istream & operator>>( std::istream &is, BasicVector<int32_t> &pt );
+template std::istream & operator>>( std::istream &is, BasicVector<int64_t> &pt );
+template std::ostream & operator<<( std::ostream &os, BasicVector<float> const &pt );
+template std::ostream & operator<<( std::ostream &os, BasicVector<double> const &pt );
+template std::ostream & operator<<( std::ostream &os, BasicVector<int32_t> const &pt );
+template std::ostream & operator<<( std::ostream &os, BasicVector<int64_t> const &pt );
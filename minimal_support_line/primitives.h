@@ -2,29 +2,34 @@
 #define PRIMITIVES_H
 
 #include <istream>
+#include <tuple>
+#include "coordinate.h"
 
 /*!
- * \brief The Point struct
+ * \brief The BasicVector class
+ * \details Point or vector with coordinates of type T, see coordinate.h.
+ * \details Instantiated for float, double, int32_t and int64_t.
  */
-class Vector
+template<class T>
+class BasicVector
 {
 public:
     /*!
      * \brief Default class constructor.
      */
-    Vector();
+    BasicVector();
 
     /*!
      * \brief Get x coordinate function.
      * \return x coordinate.
      */
-    double x() const;
+    T x() const;
 
     /*!
      * \brief Get y coordinate function.
      * \return y coordinate.
      */
-    double y() const;
+    T y() const;
 
     /*!
      * \brief Get id function.
@@ -36,7 +41,7 @@ public:
      * \brief Evaluate square of Euclid norm function.
      * \return Square of Euclid norm.
      */
-    double len2() const;
+    typename CoordinateTraits<T>::Product len2() const;
 
     /*!
      * \brief Per component class constructor function.
@@ -44,15 +49,15 @@ public:
      * \param y y.
      * \param id id.
      */
-    Vector( double _x, double _y, int _id = 0 );
+    BasicVector( T _x, T _y, int _id = 0 );
 
-    Vector & operator+=( Vector const &rhs );
+    BasicVector & operator+=( BasicVector const &rhs );
 
-    Vector & operator=( Vector const &rhs );
+    BasicVector & operator=( BasicVector const &rhs );
 
-    Vector operator-( Vector const &rhs ) const;
+    BasicVector operator-( BasicVector const &rhs ) const;
 
-    Vector operator/( double num ) const;
+    BasicVector operator/( T num ) const;
 
     double distToLine( std::tuple<double, double, double> const &line ) const;
 
@@ -61,48 +66,53 @@ public:
      * \param rhs Vector to evaluate cross product to.
      * \return Cross product.
      */
-    double crossProd( Vector const &rhs ) const;
+    typename CoordinateTraits<T>::Product crossProd( BasicVector const &rhs ) const;
 
     /*!
      * \brief Dot product function.
      * \param rhs Vector to evaluate dot product to.
      * \return Dot product.
      */
-    double dotProd( Vector const &rhs ) const;
+    typename CoordinateTraits<T>::Product dotProd( BasicVector const &rhs ) const;
 
     /*!
      * \brief Comparator function.
+     * \details Coordinates are compared exactly.
      * \param rhs Point to compare with.
      * \return true if equal, false otherwise.
      */
-    bool operator==( Vector const &rhs ) const;
+    bool operator==( BasicVector const &rhs ) const;
 
     /*!
      * \brief Strict order operator.
+     * \details Exact lexicographic order by x, then y.
      * \param rhs Point to compare with.
      * \return True if less, false otherwise.
      */
-    bool operator<( Vector const &rhs ) const;
+    bool operator<( BasicVector const &rhs ) const;
 
     /*!
      * \brief Nonstrict order operator.
      * \param rhs Point to compare with.
      * \return True if less or equal, false otherwise.
      */
-    bool operator<=( Vector const &rhs ) const;
-
-    static const double tolerance;
+    bool operator<=( BasicVector const &rhs ) const;
 
 private:
     int _id;
-    double _x, _y;
+    T _x, _y;
 };
 
+//! Point of input coordinate type
+using Vector = BasicVector<Coord>;
+
 
 /* Input operators */
-std::istream & operator>>( std::istream &is, Vector &pt );
+template<class T>
+std::istream & operator>>( std::istream &is, BasicVector<T> &pt );
 
 /* Output operators */
-std::ostream & operator<<( std::ostream &os, Vector const &pt );
+template<class T>
+std::ostream & operator<<( std::ostream &os, BasicVector<T> const &pt );
 
 #endif // PRIMITIVES_H
@@ -0,0 +1,128 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "support_line_tracker.h"
+#include "minimal_support_line.h"
+
+bool SupportLineTracker::Entry::operator<(const Entry &rhs) const
+{
+    if (key != rhs.key)
+        return key < rhs.key;
+    if (edge.first.id() != rhs.edge.first.id())
+        return edge.first.id() < rhs.edge.first.id();
+    return edge.second.id() < rhs.edge.second.id();
+}
+
+SupportLineTracker::SupportLineTracker() : scanned(0)
+{}
+
+void SupportLineTracker::insert(const Vector &point)
+{
+    size_t before = hull.size();
+    hull.insert(point, &update);
+    if (hull.size() == before)
+        return;
+
+    sumX.add(point.x());
+    sumY.add(point.y());
+    apply(update);
+}
+
+bool SupportLineTracker::erase(const Vector &point)
+{
+    if (!hull.erase(point, &update))
+        return false;
+
+    sumX.add(-static_cast<double>(point.x()));
+    sumY.add(-static_cast<double>(point.y()));
+    apply(update);
+    return true;
+}
+
+std::pair<int, int> SupportLineTracker::findMinimalSupportLine()
+{
+    if (edges.empty())
+    {
+        // single vertex hull: degenerate line through it
+        int id = hull.hull().front().id();
+        return {id, id};
+    }
+
+    auto center = massCenter();
+    double
+            drift = std::sqrt((center - reference).len2()),
+            optDist = std::numeric_limits<double>::max();
+    Entry const *optimal = nullptr;
+
+    for (Entry const &entry : edges)
+    {
+        // keys and distances are computed with rounding, compare with margin
+        double slack = 1e-12 * (entry.key + std::abs(center.x()) + std::abs(center.y()) +
+                                std::abs(entry.edge.first.x()) + std::abs(entry.edge.first.y()));
+        if (entry.key - drift - slack > optDist)
+            break;
+
+        scanned++;
+        double dist = distance(center, entry.edge);
+        if (dist < optDist || (dist == optDist && goesFirst(entry.edge, optimal->edge)))
+        {
+            optDist = dist;
+            optimal = &entry;
+        }
+    }
+
+    std::pair<int, int> result(optimal->edge.first.id(), optimal->edge.second.id());
+    if (scanned > edges.size())
+    {
+        if (drift > 0)
+            rebase(center);
+        scanned = 0;
+    }
+    return result;
+}
+
+BasicVector<double> SupportLineTracker::massCenter() const
+{
+    size_t n = hull.size();
+    if (!n)
+        return BasicVector<double>();
+    return BasicVector<double>(sumX.value() / n, sumY.value() / n);
+}
+
+const DynamicConvexHull &SupportLineTracker::convexHull() const
+{
+    return hull;
+}
+
+void SupportLineTracker::apply(const DynamicConvexHull::Update &update)
+{
+    for (auto const &edge : update.removed)
+        edges.erase(Entry{distance(reference, edge), edge});
+    for (auto const &edge : update.added)
+        edges.insert(Entry{distance(reference, edge), edge});
+}
+
+void SupportLineTracker::rebase(const BasicVector<double> &reference)
+{
+    std::vector<Entry> entries(edges.begin(), edges.end());
+    for (Entry &entry : entries)
+        entry.key = distance(reference, entry.edge);
+
+    this->reference = reference;
+    edges = std::set<Entry>(entries.begin(), entries.end());
+}
+
+bool SupportLineTracker::goesFirst(const DynamicConvexHull::Edge &lhs, const DynamicConvexHull::Edge &rhs)
+{
+    // counterclockwise from lexicographically smallest vertex: lower chain
+    // edges go left to right, upper ones back
+    bool lhsLower = lhs.first < lhs.second, rhsLower = rhs.first < rhs.second;
+    if (lhsLower != rhsLower)
+        return lhsLower;
+    return lhsLower ? lhs.first < rhs.first : rhs.first < lhs.first;
+}
+
+double SupportLineTracker::distance(const BasicVector<double> &point, const DynamicConvexHull::Edge &edge)
+{
+    return point.distToLine(MinimalSupportLine::getCanonicalLine(edge.first, edge.second));
+}
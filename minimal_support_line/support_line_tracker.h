@@ -0,0 +1,108 @@
+#ifndef SUPPORT_LINE_TRACKER_H
+#define SUPPORT_LINE_TRACKER_H
+
+#include <set>
+#include <utility>
+#include "primitives.h"
+#include "compensated_sum.h"
+#include "dynamic_convex_hull.h"
+
+/*!
+ * \brief The SupportLineTracker class
+ * \details Minimal support line of a changing point set. Keeps dynamic convex
+ * \details hull, compensated running sums of coordinates and hull edges
+ * \details ordered by distance to a reference mass center. Distance to a line
+ * \details changes no more than the point moves, so edges are scanned in that
+ * \details order only while their distance less the mass center drift can
+ * \details beat the best one. Keys are recomputed at current mass center once
+ * \details scans since last recomputation cost as much as that.
+ * \details Update costs O(log n) plus O(log h) per changed hull edge, query
+ * \details costs O(log h) plus number of edges scanned.
+ */
+class SupportLineTracker
+{
+public:
+    /*!
+     * \brief Class constructor.
+     */
+    SupportLineTracker();
+
+    /*!
+     * \brief Insert point function.
+     * \param point Point.
+     */
+    void insert( Vector const &point );
+
+    /*!
+     * \brief Erase point function.
+     * \param point Point, coordinates and id must match inserted one.
+     * \return false if point was not inserted.
+     */
+    bool erase( Vector const &point );
+
+    /*!
+     * \brief Find minimal support line function.
+     * \details Same line as MinimalSupportLine finds over the same points,
+     * \details up to rounding of mass center. Point set must not be empty.
+     * \return Identifiers of the optimal hull edge ends.
+     */
+    std::pair<int, int> findMinimalSupportLine();
+
+    /*!
+     * \brief Get mass center function.
+     * \return Mass center of point set.
+     */
+    BasicVector<double> massCenter() const;
+
+    /*!
+     * \brief Get convex hull function.
+     * \return Dynamic convex hull of point set.
+     */
+    DynamicConvexHull const & convexHull() const;
+
+private:
+    /*!
+     * \brief The Entry struct
+     * \details Hull edge and its distance to reference mass center.
+     */
+    struct Entry
+    {
+        double key;
+        DynamicConvexHull::Edge edge;
+
+        bool operator<( Entry const &rhs ) const;
+    };
+
+    /*!
+     * \brief Apply hull update to edge order function.
+     */
+    void apply( DynamicConvexHull::Update const &update );
+
+    /*!
+     * \brief Recompute edge keys at new reference function.
+     * \param reference New reference mass center.
+     */
+    void rebase( BasicVector<double> const &reference );
+
+    /*!
+     * \brief Check edge goes first in hull order function.
+     * \details Order of ConvexHullGraham hull, ties are broken by it.
+     * \return true if lhs goes before rhs.
+     */
+    static bool goesFirst( DynamicConvexHull::Edge const &lhs, DynamicConvexHull::Edge const &rhs );
+
+    /*!
+     * \brief Get distance of point to edge line function.
+     */
+    static double distance( BasicVector<double> const &point, DynamicConvexHull::Edge const &edge );
+
+    DynamicConvexHull hull;
+    DynamicConvexHull::Update update;
+    CompensatedSum sumX, sumY;
+    std::set<Entry> edges;
+    BasicVector<double> reference;
+    //! Edges scanned since last rebase
+    size_t scanned;
+};
+
+#endif // SUPPORT_LINE_TRACKER_H
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "segment_generator.h"
+#include "intersector.h"
+#include "intersection_sink.h"
+#include "radix_sort.h"
+#include "thread_pool.h"
+
+//! Synthetic segment distributions
+enum class Distribution { UNIFORM, MESH, LONG_HORIZONTALS };
+
+namespace
+{
+
+const uint64_t seed = 20240611;
+
+/*!
+ * \brief Generate segments function.
+ * \param distribution Distribution.
+ * \param n Number of segments.
+ * \return Segments.
+ */
+std::vector<Segment> generate( Distribution distribution, std::size_t n )
+{
+    SegmentGenerator generator(seed);
+    switch (distribution)
+    {
+    case Distribution::UNIFORM:
+        return generator.uniform(n);
+    case Distribution::MESH:
+        return generator.mesh(n);
+    case Distribution::LONG_HORIZONTALS:
+        return generator.longHorizontals(n);
+    }
+    return std::vector<Segment>();
+}
+
+/*!
+ * \brief Make sweep events function.
+ * \details The events Intersector sorts: both ends of horizontals, lower
+ * \details end of verticals, in input order.
+ * \param segments Segments.
+ * \return Events.
+ */
+std::vector<Event> makeEvents( std::vector<Segment> const &segments )
+{
+    std::vector<Event> events;
+    for (uint32_t i = 0; i < segments.size(); i++)
+    {
+        auto &s = segments[i];
+        switch (s.orientation())
+        {
+        case Segment::Orientation::HORIZONTAL:
+            events.push_back({Event::makeKey(s, Event::EndType::LEFT_LOW), i, Event::EndType::LEFT_LOW});
+            events.push_back({Event::makeKey(s, Event::EndType::RIGHT_UP), i, Event::EndType::RIGHT_UP});
+            break;
+        case Segment::Orientation::VERTICAL:
+            events.push_back({Event::makeKey(s, Event::EndType::LEFT_LOW), i, Event::EndType::LEFT_LOW});
+            break;
+        default:
+            break;
+        }
+    }
+    return events;
+}
+
+//! Segment counts from 1e3 to 1e8
+std::vector<int64_t> sizes()
+{
+    return benchmark::CreateRange(1000, 100000000, 10);
+}
+
+} // namespace
+
+/*!
+ * \brief Sort points by Point comparator benchmark.
+ * \details Arguments: number of points.
+ */
+void BM_PointLess( benchmark::State &state )
+{
+    auto n = static_cast<std::size_t>(state.range(0));
+    std::vector<Point> points;
+    for (auto &s : SegmentGenerator(seed).uniform(n))
+        points.push_back(s.p0());
+    std::vector<Point> sorted;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sorted = points;
+        state.ResumeTiming();
+        std::sort(sorted.begin(), sorted.end());
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointLess)->ArgsProduct({sizes()})->Unit(benchmark::kMillisecond);
+
+/*!
+ * \brief Sort sweep events by LessEvent comparator benchmark.
+ * \details Arguments: number of segments.
+ */
+void BM_SortEventsLessEvent( benchmark::State &state, Distribution distribution )
+{
+    auto segments = generate(distribution, static_cast<std::size_t>(state.range(0)));
+    auto events = makeEvents(segments);
+    std::vector<Event> sorted;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sorted = events;
+        state.ResumeTiming();
+        std::stable_sort(sorted.begin(), sorted.end(), LessEvent(segments));
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK_CAPTURE(BM_SortEventsLessEvent, uniform, Distribution::UNIFORM)
+    ->ArgsProduct({sizes()})->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_SortEventsLessEvent, mesh, Distribution::MESH)
+    ->ArgsProduct({sizes()})->Unit(benchmark::kMillisecond);
+
+/*!
+ * \brief Radix sort sweep events by key benchmark, as Intersector does.
+ * \details Arguments: number of segments, threads (0 -- all cores).
+ */
+void BM_SortEventsRadix( benchmark::State &state, Distribution distribution )
+{
+    auto segments = generate(distribution, static_cast<std::size_t>(state.range(0)));
+    auto events = makeEvents(segments);
+    ThreadPool pool(static_cast<unsigned>(state.range(1)));
+    std::vector<Event> sorted;
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        sorted = events;
+        state.ResumeTiming();
+        radixSort(sorted, []( Event const &event ) { return event.key; }, &pool);
+        benchmark::DoNotOptimize(sorted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK_CAPTURE(BM_SortEventsRadix, uniform, Distribution::UNIFORM)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_SortEventsRadix, mesh, Distribution::MESH)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/*!
+ * \brief Find intersections benchmark, intersections are counted only.
+ * \details Arguments: number of segments, threads (0 -- all cores).
+ */
+void BM_Intersector( benchmark::State &state, Distribution distribution )
+{
+    auto segments = generate(distribution, static_cast<std::size_t>(state.range(0)));
+    ThreadPool pool(static_cast<unsigned>(state.range(1)));
+
+    uint64_t intersections = 0;
+    for (auto _ : state)
+    {
+        CountSink sink;
+        Intersector intersector;
+        intersector.computeIntersections(segments, sink, &pool);
+        intersections = sink.count();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["intersections"] = static_cast<double>(intersections);
+}
+BENCHMARK_CAPTURE(BM_Intersector, uniform, Distribution::UNIFORM)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Intersector, mesh, Distribution::MESH)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_CAPTURE(BM_Intersector, long_horizontals, Distribution::LONG_HORIZONTALS)
+    ->ArgsProduct({sizes(), {1, 0}})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
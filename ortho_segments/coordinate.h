@@ -0,0 +1,84 @@
+#ifndef COORDINATE_H
+#define COORDINATE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "binary_format.h"
+
+#ifndef COORD_TYPE
+#define COORD_TYPE float
+#endif
+
+/*!
+ * \brief Coordinate type.
+ * \details Chosen at build time: cmake -DCOORD_TYPE=int32_t. Supported are
+ * \details float and int32_t: sweep event keys and binary intersection
+ * \details records hold 32 bit coordinates. Integer coordinates are
+ * \details compared exactly; crossings of general segments are rounded.
+ * \details int32_t coordinates must lie strictly between INT32_MIN and
+ * \details INT32_MAX, these two are reserved for event ranks.
+ */
+using Coord = COORD_TYPE;
+
+static_assert(sizeof(Coord) == 4, "coordinate type must be 32 bit");
+
+/*!
+ * \brief The CoordinateTraits struct
+ * \details Scalar is the binary file column type.
+ */
+template<class T>
+struct CoordinateTraits;
+
+template<>
+struct CoordinateTraits<float>
+{
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::FLOAT32; }
+};
+
+template<>
+struct CoordinateTraits<int32_t>
+{
+    static BinaryFormat::Scalar scalar() { return BinaryFormat::Scalar::INT32; }
+};
+
+/*!
+ * \brief Round number to nearest coordinate function.
+ * \param value Number.
+ * \return Coordinate.
+ */
+inline Coord roundToCoordinate( double value )
+{
+    return std::numeric_limits<Coord>::is_integer ?
+                static_cast<Coord>(std::llround(value)) : static_cast<Coord>(value);
+}
+
+/*!
+ * \brief Check coordinate is not reserved function.
+ * \details int32_t builds reserve INT32_MIN and INT32_MAX for event ranks.
+ * \param value Coordinate.
+ * \return true if coordinate may be loaded.
+ */
+inline bool isAllowedCoordinate( Coord value )
+{
+    return !std::numeric_limits<Coord>::is_integer ||
+            (value != std::numeric_limits<Coord>::lowest() && value != std::numeric_limits<Coord>::max());
+}
+
+/*!
+ * \brief Check binary column can be read as coordinates function.
+ * \details Integer builds read only integer columns not wider than Coord,
+ * \details floating point builds read any column.
+ * \param scalar Column type.
+ * \return true if readable.
+ */
+inline bool isCoordinateScalar( BinaryFormat::Scalar scalar )
+{
+    if (!std::numeric_limits<Coord>::is_integer)
+        return true;
+    return (scalar == BinaryFormat::Scalar::INT32 || scalar == BinaryFormat::Scalar::INT64) &&
+            BinaryFormat::scalarSize(scalar) <= sizeof(Coord);
+}
+
+#endif // COORDINATE_H
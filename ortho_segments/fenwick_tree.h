@@ -0,0 +1,59 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+#include <cstddef>
+#include <vector>
+
+/*!
+ * \brief The FenwickTree class
+ * \details Binary indexed tree: point update and prefix sum in O(log n).
+ */
+template<class T>
+class FenwickTree
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param n Number of elements, all zero.
+     */
+    explicit FenwickTree( std::size_t n ) : tree(n + 1, T()) {}
+
+    /*!
+     * \brief Add value to element function.
+     * \param i Element number.
+     * \param delta Value to add.
+     */
+    void add( std::size_t i, T delta )
+    {
+        for (i++; i < tree.size(); i += i & (~i + 1))
+            tree[i] += delta;
+    }
+
+    /*!
+     * \brief Prefix sum function.
+     * \param i Number of leading elements.
+     * \return Sum of elements [0, i).
+     */
+    T prefix( std::size_t i ) const
+    {
+        T sum = T();
+        for (; i > 0; i -= i & (~i + 1))
+            sum += tree[i];
+        return sum;
+    }
+
+    /*!
+     * \brief Get number of elements function.
+     * \return Number of elements.
+     */
+    std::size_t size() const
+    {
+        return tree.size() - 1;
+    }
+
+private:
+    //! 1-based tree, tree[0] unused
+    std::vector<T> tree;
+};
+
+#endif // FENWICK_TREE_H
@@ -0,0 +1,475 @@
+#include <algorithm>
+#include <iterator>
+#include "general_intersector.h"
+#include "predicates.h"
+
+const uint32_t GeneralIntersector::probeBelow = 0xFFFFFFFEu;
+const uint32_t GeneralIntersector::probeAbove = 0xFFFFFFFFu;
+const std::size_t GeneralIntersector::batchSize = 1 << 14;
+
+namespace
+{
+const uint32_t noSegment = 0xFFFFFFFFu;
+
+/*!
+ * \brief The PointRef struct
+ * \details Event point as seen by predicates: input end point or crossing
+ * \details of segments a and b, such that a x b > 0 for their directions.
+ */
+struct PointRef
+{
+    bool crossing;
+    Point end;
+    Segment const *a, *b;
+};
+
+bool isVertical( Segment const &s )
+{
+    return s.p0().x == s.p1().x;
+}
+
+bool isHorizontal( Segment const &s )
+{
+    return s.p0().y == s.p1().y;
+}
+
+/*!
+ * \brief Cross product of segment directions.
+ */
+struct CrossDirections
+{
+    Segment const &a, &b;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        T
+                dax = T(a.p1().x) - T(a.p0().x),
+                day = T(a.p1().y) - T(a.p0().y),
+                dbx = T(b.p1().x) - T(b.p0().x),
+                dby = T(b.p1().y) - T(b.p0().y);
+        return dax * dby - day * dbx;
+    }
+};
+
+template<class T>
+struct Homogeneous
+{
+    //! Point is (x / w, y / w), w > 0
+    T x, y, w;
+};
+
+template<class T>
+Homogeneous<T> homogeneous( PointRef const &p )
+{
+    if (!p.crossing)
+        return {T(p.end.x), T(p.end.y), T(1)};
+
+    // a0 + (a1 - a0) * n / w
+    auto &a = *p.a, &b = *p.b;
+    T
+            a0x = T(a.p0().x), a0y = T(a.p0().y),
+            dax = T(a.p1().x) - a0x,
+            day = T(a.p1().y) - a0y,
+            dbx = T(b.p1().x) - T(b.p0().x),
+            dby = T(b.p1().y) - T(b.p0().y),
+            w = dax * dby - day * dbx,
+            n = (T(b.p0().x) - a0x) * dby - (T(b.p0().y) - a0y) * dbx;
+    return {a0x * w + dax * n, a0y * w + day * n, w};
+}
+
+/*!
+ * \brief Difference of point coordinates, scaled by positive weights.
+ */
+struct CoordinateDifference
+{
+    PointRef const &p, &q;
+    bool y;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        auto hp = homogeneous<T>(p), hq = homogeneous<T>(q);
+        return y ? hp.y * hq.w - hq.y * hp.w : hp.x * hq.w - hq.x * hp.w;
+    }
+};
+
+/*!
+ * \brief Orientation of point relative to segment, scaled by positive weight.
+ */
+struct PointOrientation
+{
+    Segment const &s;
+    PointRef const &p;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        auto h = homogeneous<T>(p);
+        T
+                s0x = T(s.p0().x), s0y = T(s.p0().y),
+                dx = T(s.p1().x) - s0x,
+                dy = T(s.p1().y) - s0y;
+        return dx * (h.y - s0y * h.w) - dy * (h.x - s0x * h.w);
+    }
+};
+
+/*!
+ * \brief Difference of point y and value, scaled by positive weight.
+ */
+struct DifferenceY
+{
+    PointRef const &p;
+    Coord y;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        auto h = homogeneous<T>(p);
+        return h.y - T(y) * h.w;
+    }
+};
+
+/*!
+ * \brief Difference of y of two nonvertical segments at x of point,
+ * \brief scaled by positive factor.
+ */
+struct DifferenceAtX
+{
+    Segment const &a, &b;
+    PointRef const &p;
+
+    template<class T>
+    T operator()( T * ) const
+    {
+        auto h = homogeneous<T>(p);
+        T
+                a0x = T(a.p0().x), a0y = T(a.p0().y),
+                dax = T(a.p1().x) - a0x, day = T(a.p1().y) - a0y,
+                b0x = T(b.p0().x), b0y = T(b.p0().y),
+                dbx = T(b.p1().x) - b0x, dby = T(b.p1().y) - b0y;
+        // y_a(x) * dax * w = a0y * dax * w + day * (x - a0x * w)
+        T
+                ya = a0y * dax * h.w + day * (h.x - a0x * h.w),
+                yb = b0y * dbx * h.w + dby * (h.x - b0x * h.w);
+        return ya * dbx - yb * dax;
+    }
+};
+
+PointRef makeRef( std::vector<Segment> const &segments, uint32_t a, uint32_t b, bool crossing, bool left )
+{
+    PointRef ref;
+    ref.crossing = crossing;
+    ref.a = &segments[a];
+    ref.b = crossing ? &segments[b] : nullptr;
+    if (!crossing)
+        ref.end = left ? ref.a->p0() : ref.a->p1();
+    // crossing of horizontal and vertical is a point of coordinate type,
+    // predicates then take their fast paths
+    else if (isVertical(*ref.a) && isHorizontal(*ref.b))
+    {
+        ref.crossing = false;
+        ref.end = Point(ref.a->p0().x, ref.b->p0().y);
+    }
+    else if (isHorizontal(*ref.a) && isVertical(*ref.b))
+    {
+        ref.crossing = false;
+        ref.end = Point(ref.b->p0().x, ref.a->p0().y);
+    }
+    return ref;
+}
+
+int comparePoints( PointRef const &p, PointRef const &q )
+{
+    if (!p.crossing && !q.crossing)
+    {
+        if (p.end.x != q.end.x)
+            return p.end.x < q.end.x ? -1 : 1;
+        if (p.end.y != q.end.y)
+            return p.end.y < q.end.y ? -1 : 1;
+        return 0;
+    }
+    int sx = exactSign(CoordinateDifference{p, q, false});
+    return sx != 0 ? sx : exactSign(CoordinateDifference{p, q, true});
+}
+
+int orientation( Segment const &s, PointRef const &p )
+{
+    if (!p.crossing)
+    {
+        double det = Predicates::orient2d(s.p0().x, s.p0().y, s.p1().x, s.p1().y, p.end.x, p.end.y);
+        return det > 0 ? 1 : (det < 0 ? -1 : 0);
+    }
+    return exactSign(PointOrientation{s, p});
+}
+
+int compareY( PointRef const &p, Coord y )
+{
+    if (!p.crossing)
+        return p.end.y < y ? -1 : (p.end.y > y ? 1 : 0);
+    return exactSign(DifferenceY{p, y});
+}
+
+//! Segment end later in sweep order
+Point farEnd( Segment const &s )
+{
+    return s.p0() < s.p1() ? s.p1() : s.p0();
+}
+
+bool properlyCross( Segment const &a, Segment const &b )
+{
+    auto orient = []( Point const &p, Point const &q, Point const &r )
+    {
+        double det = Predicates::orient2d(p.x, p.y, q.x, q.y, r.x, r.y);
+        return det > 0 ? 1 : (det < 0 ? -1 : 0);
+    };
+    return orient(a.p0(), a.p1(), b.p0()) * orient(a.p0(), a.p1(), b.p1()) < 0 &&
+           orient(b.p0(), b.p1(), a.p0()) * orient(b.p0(), b.p1(), a.p1()) < 0;
+}
+}
+
+GeneralIntersector::LessPoint::LessPoint( std::vector<Segment> const *segments ) : segments(segments) {}
+
+bool GeneralIntersector::LessPoint::operator()( EventPoint const &lhs, EventPoint const &rhs ) const
+{
+    if (lhs.kind == EventPoint::Kind::CROSSING && rhs.kind == EventPoint::Kind::CROSSING &&
+        lhs.a == rhs.a && lhs.b == rhs.b)
+        return false;
+    return comparePoints(
+                makeRef(*segments, lhs.a, lhs.b, lhs.kind == EventPoint::Kind::CROSSING,
+                        lhs.kind == EventPoint::Kind::LEFT_END),
+                makeRef(*segments, rhs.a, rhs.b, rhs.kind == EventPoint::Kind::CROSSING,
+                        rhs.kind == EventPoint::Kind::LEFT_END)) < 0;
+}
+
+GeneralIntersector::LessStatus::LessStatus( GeneralIntersector const *owner ) : owner(owner) {}
+
+bool GeneralIntersector::LessStatus::operator()( uint32_t lhs, uint32_t rhs ) const
+{
+    if (lhs == probeBelow)
+        return owner->side(rhs) >= 0;
+    if (lhs == probeAbove)
+        return owner->side(rhs) > 0;
+    if (rhs == probeBelow)
+        return owner->side(lhs) < 0;
+    if (rhs == probeAbove)
+        return owner->side(lhs) <= 0;
+
+    int
+            lhs_side = owner->side(lhs),
+            rhs_side = owner->side(rhs);
+    if (lhs_side != rhs_side)
+        return lhs_side < rhs_side;
+    if (lhs_side == 0)
+        return owner->lessThrough(lhs, rhs);
+    return owner->lessAtX(lhs, rhs);
+}
+
+GeneralIntersector::GeneralIntersector() :
+    segments(nullptr), queue(LessPoint(nullptr)), status(LessStatus(this)), currentExact(false) {}
+
+void GeneralIntersector::start( std::vector<Segment> const &segments )
+{
+    this->segments = &segments;
+    queue = EventQueue(LessPoint(&segments));
+    status.clear();
+
+    for (uint32_t i = 0; i < segments.size(); i++)
+    {
+        queue[{i, i, EventPoint::Kind::LEFT_END}].push_back(i);
+        queue.insert({{i, i, EventPoint::Kind::RIGHT_END}, {}});
+    }
+}
+
+bool GeneralIntersector::advance( std::vector<Intersection> &batch )
+{
+    while (!queue.empty() && batch.size() < batchSize)
+    {
+        auto it = queue.begin();
+        current = it->first;
+        PointRef ref = makeRef(*segments, current.a, current.b,
+                               current.kind == EventPoint::Kind::CROSSING,
+                               current.kind == EventPoint::Kind::LEFT_END);
+        currentExact = !ref.crossing;
+        currentEnd = ref.end;
+        std::vector<uint32_t> upper = std::move(it->second);
+        queue.erase(it);
+        handleEvent(upper, batch);
+    }
+    return !queue.empty();
+}
+
+void GeneralIntersector::handleEvent( std::vector<uint32_t> const &upper, std::vector<Intersection> &batch )
+{
+    // active segments through current point are contiguous in status
+    auto
+            lo = status.lower_bound(probeBelow),
+            hi = status.lower_bound(probeAbove);
+    through.assign(lo, hi);
+    uint32_t
+            below = lo == status.begin() ? noSegment : *std::prev(lo),
+            above = hi == status.end() ? noSegment : *hi;
+
+    involved = through;
+    involved.insert(involved.end(), upper.begin(), upper.end());
+    if (involved.size() > 1)
+    {
+        std::sort(involved.begin(), involved.end());
+        std::sort(through.begin(), through.end());
+        Point pt = currentPoint();
+        auto &s = *segments;
+        for (size_t i = 0; i < involved.size(); i++)
+        {
+            bool i_through = std::binary_search(through.begin(), through.end(), involved[i]);
+            for (size_t j = i + 1; j < involved.size(); j++)
+            {
+                // overlapping segments share many event points, they are
+                // reported where the later one starts
+                auto &a = s[involved[i]], &b = s[involved[j]];
+                bool parallel = exactSign(CrossDirections{a, b}) == 0;
+                if (parallel && i_through && std::binary_search(through.begin(), through.end(), involved[j]))
+                    continue;
+                // common part of collinear segments ends at nearer far end,
+                // as in Intersector
+                Point end = parallel ? std::min(farEnd(a), farEnd(b)) : pt;
+                batch.push_back({a.id(), b.id(), pt, end});
+            }
+        }
+    }
+
+    // reinsert segments going on, now ordered as just after current point
+    status.erase(lo, hi);
+    bool inserted = false;
+    for (auto segment : involved)
+        if (!endsHere(segment))
+        {
+            status.insert(segment);
+            inserted = true;
+        }
+
+    if (!inserted)
+    {
+        if (below != noSegment && above != noSegment)
+            findNewEvent(below, above);
+        return;
+    }
+
+    lo = status.lower_bound(probeBelow);
+    hi = status.lower_bound(probeAbove);
+    if (below != noSegment)
+        findNewEvent(below, *lo);
+    if (above != noSegment)
+        findNewEvent(*std::prev(hi), above);
+}
+
+void GeneralIntersector::findNewEvent( uint32_t lhs, uint32_t rhs )
+{
+    auto &s = *segments;
+    // touching at ends and overlaps are found at end events
+    if (!properlyCross(s[lhs], s[rhs]))
+        return;
+
+    // order crossing segments so that homogeneous weight is positive
+    if (exactSign(CrossDirections{s[lhs], s[rhs]}) < 0)
+        std::swap(lhs, rhs);
+    EventPoint crossing = {lhs, rhs, EventPoint::Kind::CROSSING};
+    if (LessPoint(segments)(current, crossing))
+        queue.insert({crossing, {}});
+}
+
+int GeneralIntersector::side( uint32_t segment ) const
+{
+    // segment goes through its own crossings, exact zero is not filtered
+    if (current.kind == EventPoint::Kind::CROSSING && (segment == current.a || segment == current.b))
+        return 0;
+
+    auto &s = (*segments)[segment];
+    if (currentExact)
+    {
+        Point pt = currentEnd;
+        if (isVertical(s))
+            return pt.y < s.p0().y ? 1 : (s.p1().y < pt.y ? -1 : 0);
+        if (isHorizontal(s))
+            return pt.y < s.p0().y ? 1 : (s.p0().y < pt.y ? -1 : 0);
+        double det = Predicates::orient2d(s.p0().x, s.p0().y, s.p1().x, s.p1().y, pt.x, pt.y);
+        return det > 0 ? -1 : (det < 0 ? 1 : 0);
+    }
+
+    PointRef p = makeRef(*segments, current.a, current.b, true, false);
+
+    // active vertical segment lies on sweep line
+    if (isVertical(s))
+    {
+        if (compareY(p, s.p0().y) < 0)
+            return 1;
+        if (compareY(p, s.p1().y) > 0)
+            return -1;
+        return 0;
+    }
+
+    // point to the left of segment direction is above segment
+    return -orientation(s, p);
+}
+
+bool GeneralIntersector::lessThrough( uint32_t lhs, uint32_t rhs ) const
+{
+    auto &s = *segments;
+    bool
+            lhs_vertical = isVertical(s[lhs]),
+            rhs_vertical = isVertical(s[rhs]);
+    // vertical segments are above all others after current point
+    if (lhs_vertical != rhs_vertical)
+        return rhs_vertical;
+    if (!lhs_vertical)
+    {
+        // segment with less slope goes lower
+        int cross = exactSign(CrossDirections{s[lhs], s[rhs]});
+        if (cross != 0)
+            return cross > 0;
+    }
+    return lhs < rhs;
+}
+
+bool GeneralIntersector::lessAtX( uint32_t lhs, uint32_t rhs ) const
+{
+    auto &s = *segments;
+    if (isVertical(s[lhs]) || isVertical(s[rhs]))
+        return lhs < rhs;
+    if (isHorizontal(s[lhs]) && isHorizontal(s[rhs]) && s[lhs].p0().y != s[rhs].p0().y)
+        return s[lhs].p0().y < s[rhs].p0().y;
+
+    PointRef p = makeRef(s, current.a, current.b,
+                         current.kind == EventPoint::Kind::CROSSING,
+                         current.kind == EventPoint::Kind::LEFT_END);
+    int diff = exactSign(DifferenceAtX{s[lhs], s[rhs], p});
+    if (diff != 0)
+        return diff < 0;
+    return lessThrough(lhs, rhs);
+}
+
+bool GeneralIntersector::endsHere( uint32_t segment ) const
+{
+    // crossings never coincide with ends: equal end point event is used instead
+    if (current.kind == EventPoint::Kind::CROSSING)
+        return false;
+    auto &s = *segments;
+    Point pt = current.kind == EventPoint::Kind::LEFT_END ? s[current.a].p0() : s[current.a].p1();
+    return s[segment].p1().x == pt.x && s[segment].p1().y == pt.y;
+}
+
+Point GeneralIntersector::currentPoint() const
+{
+    auto &s = *segments;
+    if (current.kind == EventPoint::Kind::LEFT_END)
+        return s[current.a].p0();
+    if (current.kind == EventPoint::Kind::RIGHT_END)
+        return s[current.a].p1();
+
+    auto &a = s[current.a], &b = s[current.b];
+    double
+            a0x = a.p0().x, a0y = a.p0().y,
+            dax = a.p1().x - a0x, day = a.p1().y - a0y,
+            dbx = double(b.p1().x) - b.p0().x, dby = double(b.p1().y) - b.p0().y,
+            t = ((b.p0().x - a0x) * dby - (b.p0().y - a0y) * dbx) / (dax * dby - day * dbx);
+    return {roundToCoordinate(a0x + dax * t), roundToCoordinate(a0y + day * t)};
+}
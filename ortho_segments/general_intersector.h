@@ -0,0 +1,175 @@
+#ifndef GENERAL_INTERSECTOR_H
+#define GENERAL_INTERSECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+#include "primitives.h"
+#include "intersection_sink.h"
+
+/*!
+ * \brief The GeneralIntersector class
+ * \details Bentley-Ottmann sweep for segments of any direction, in
+ * \details O((n + k) log n) for k intersecting pairs. Sweep line is vertical
+ * \details and moves over event points in (x, y) order; status holds active
+ * \details segments ordered by y on sweep line just after current point.
+ * \details Crossing points are kept implicitly as pairs of segments and all
+ * \details decisions are made by exact predicates (see predicates.h), so
+ * \details degenerate input (common points of many segments, touching,
+ * \details collinear overlaps, vertical and zero length segments) is fine.
+ * \details Every intersecting pair is reported once, with ids in input
+ * \details order and first common point (rounded to coordinate type);
+ * \details collinear overlaps are reported with their far end as well.
+ */
+class GeneralIntersector
+{
+public:
+    GeneralIntersector();
+
+    GeneralIntersector( GeneralIntersector const & ) = delete;
+    GeneralIntersector & operator=( GeneralIntersector const & ) = delete;
+
+    /*!
+     * \brief Compute intersections function.
+     * \param segments Segment list.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     */
+    template<class Sink>
+    void computeIntersections( std::vector<Segment> const &segments, Sink &sink );
+
+private:
+    /*!
+     * \brief The EventPoint struct
+     * \details Segment end or crossing point of two segments.
+     */
+    struct EventPoint
+    {
+        enum class Kind : uint32_t
+        {
+            LEFT_END, RIGHT_END, CROSSING
+        };
+
+        //! Segment for ends; crossing segments for crossings, ordered so
+        //! that cross product of a and b directions is positive
+        uint32_t a, b;
+        Kind kind;
+    };
+
+    class LessPoint
+    {
+    public:
+        LessPoint( std::vector<Segment> const *segments );
+        bool operator()( EventPoint const &lhs, EventPoint const &rhs ) const;
+    private:
+        std::vector<Segment> const *segments;
+    };
+
+    class LessStatus
+    {
+    public:
+        LessStatus( GeneralIntersector const *owner );
+        bool operator()( uint32_t lhs, uint32_t rhs ) const;
+    private:
+        GeneralIntersector const *owner;
+    };
+
+    //! Event queue: event point and segments with left end there
+    using EventQueue = std::map<EventPoint, std::vector<uint32_t>, LessPoint>;
+    using Status = std::set<uint32_t, LessStatus>;
+
+    //! Status keys below and above all segments passing through current point
+    static const uint32_t probeBelow, probeAbove;
+    //! Number of intersections passed to sink at once
+    static const std::size_t batchSize;
+
+    /*!
+     * \brief Fill event queue function.
+     * \param segments Segment list.
+     */
+    void start( std::vector<Segment> const &segments );
+
+    /*!
+     * \brief Process events until batch is full function.
+     * \param batch[OUT] Intersections found.
+     * \return false if no events are left, true otherwise.
+     */
+    bool advance( std::vector<Intersection> &batch );
+
+    /*!
+     * \brief Process event point function.
+     * \param upper Segments having left end at current point.
+     * \param batch[OUT] Intersections found.
+     */
+    void handleEvent( std::vector<uint32_t> const &upper, std::vector<Intersection> &batch );
+
+    /*!
+     * \brief Schedule crossing of neighbours function.
+     * \param lhs Lower segment.
+     * \param rhs Upper segment.
+     */
+    void findNewEvent( uint32_t lhs, uint32_t rhs );
+
+    /*!
+     * \brief Position of segment relative to current point function.
+     * \param segment Active segment.
+     * \return -1 if segment goes below current point, 0 through it, 1 above.
+     */
+    int side( uint32_t segment ) const;
+
+    /*!
+     * \brief Order of segments passing through current point function.
+     * \return true if lhs is below rhs just after current point.
+     */
+    bool lessThrough( uint32_t lhs, uint32_t rhs ) const;
+
+    /*!
+     * \brief Order of segments on the same side of current point function.
+     * \return true if lhs is below rhs at x of current point.
+     */
+    bool lessAtX( uint32_t lhs, uint32_t rhs ) const;
+
+    /*!
+     * \brief Check segment ends at current point function.
+     * \param segment Segment.
+     * \return true if right (upper) end is current point.
+     */
+    bool endsHere( uint32_t segment ) const;
+
+    /*!
+     * \brief Get current point coordinates function.
+     * \return Point rounded to coordinate type.
+     */
+    Point currentPoint() const;
+
+    std::vector<Segment> const *segments;
+    EventQueue queue;
+    Status status;
+    //! Current event point
+    EventPoint current;
+    //! Current point is an end or a crossing of horizontal and vertical
+    bool currentExact;
+    //! Current point if it is exact
+    Point currentEnd;
+    //! Reusable buffers of handleEvent
+    std::vector<uint32_t> through, involved;
+};
+
+template<class Sink>
+void GeneralIntersector::computeIntersections( std::vector<Segment> const &segments, Sink &sink )
+{
+    start(segments);
+
+    std::vector<Intersection> batch;
+    bool more;
+    do
+    {
+        more = advance(batch);
+        for (auto &inter : batch)
+            sink(inter);
+        batch.clear();
+    } while (more);
+}
+
+#endif // GENERAL_INTERSECTOR_H
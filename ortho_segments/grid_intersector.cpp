@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "grid_intersector.h"
+
+const std::size_t GridIntersector::cellsPerSegment = 2;
+const std::size_t GridIntersector::cellsPerTask = 1 << 12;
+
+std::size_t GridIntersector::Grid::column( Coord x ) const
+{
+    return std::min(columns - 1, static_cast<std::size_t>((x - minX) * inverseCellSize));
+}
+
+std::size_t GridIntersector::Grid::row( Coord y ) const
+{
+    return std::min(rows - 1, static_cast<std::size_t>((y - minY) * inverseCellSize));
+}
+
+void GridIntersector::computeIntersections( std::vector<Segment> const &segments, std::ostream *os,
+                                            ThreadPool *pool )
+{
+    TextSink sink(*os);
+    computeIntersections(segments, sink, pool);
+}
+
+void GridIntersector::build( std::vector<Segment> const &segments, Grid &grid, bool fill )
+{
+    // the same coordinates as sweep uses: x of vertical and y of horizontal at p0
+    double
+            minX = INFINITY, minY = INFINITY,
+            maxX = -INFINITY, maxY = -INFINITY,
+            length = 0;
+    std::size_t n = 0;
+    for (auto &s : segments)
+    {
+        switch (s.orientation())
+        {
+        case Segment::Orientation::HORIZONTAL:
+            minX = std::min<double>(minX, s.p0().x);
+            maxX = std::max<double>(maxX, s.p1().x);
+            minY = std::min<double>(minY, s.p0().y);
+            maxY = std::max<double>(maxY, s.p0().y);
+            length += double(s.p1().x) - s.p0().x;
+            n++;
+            break;
+        case Segment::Orientation::VERTICAL:
+            minX = std::min<double>(minX, s.p0().x);
+            maxX = std::max<double>(maxX, s.p0().x);
+            minY = std::min<double>(minY, s.p0().y);
+            maxY = std::max<double>(maxY, s.p1().y);
+            length += double(s.p1().y) - s.p0().y;
+            n++;
+            break;
+        default:
+            break;
+        }
+    }
+
+    double cellSize = 1;
+    if (n > 0)
+    {
+        double
+                width = maxX - minX,
+                height = maxY - minY,
+                maxCells = double(cellsPerSegment * n);
+        cellSize = length / n;
+        if (!(cellSize > 0) || (width / cellSize + 1) * (height / cellSize + 1) > maxCells)
+        {
+            // the smallest size giving at most maxCells cells
+            double
+                    a = maxCells - 1,
+                    b = width + height,
+                    c = width * height;
+            cellSize = a > 0 ? (b + std::sqrt(b * b + 4 * a * c)) / (2 * a) : std::max(width, height);
+        }
+        if (!(cellSize > 0))
+            cellSize = 1;
+    }
+    else
+        minX = minY = maxX = maxY = 0;
+
+    grid.minX = minX;
+    grid.minY = minY;
+    grid.inverseCellSize = 1 / cellSize;
+    grid.columns = static_cast<std::size_t>((maxX - minX) * grid.inverseCellSize) + 1;
+    grid.rows = static_cast<std::size_t>((maxY - minY) * grid.inverseCellSize) + 1;
+
+    std::size_t cells = grid.columns * grid.rows;
+    grid.horizontalStart.assign(cells + 1, 0);
+    grid.verticalStart.assign(cells + 1, 0);
+
+    // count, prefix sums, then fill lists in input order
+    auto forCells = [&grid]( Segment const &s, std::function<void( std::size_t )> const &visit )
+    {
+        if (s.orientation() == Segment::Orientation::HORIZONTAL)
+        {
+            std::size_t r = grid.row(s.p0().y) * grid.columns;
+            for (std::size_t c = grid.column(s.p0().x), last = grid.column(s.p1().x); c <= last; c++)
+                visit(r + c);
+        }
+        else if (s.orientation() == Segment::Orientation::VERTICAL)
+        {
+            std::size_t c = grid.column(s.p0().x);
+            for (std::size_t r = grid.row(s.p0().y), last = grid.row(s.p1().y); r <= last; r++)
+                visit(r * grid.columns + c);
+        }
+    };
+
+    for (auto &s : segments)
+    {
+        auto &start = s.orientation() == Segment::Orientation::HORIZONTAL ?
+                    grid.horizontalStart : grid.verticalStart;
+        forCells(s, [&start]( std::size_t cell ) { start[cell + 1]++; });
+    }
+    for (std::size_t cell = 0; cell < cells; cell++)
+    {
+        grid.horizontalStart[cell + 1] += grid.horizontalStart[cell];
+        grid.verticalStart[cell + 1] += grid.verticalStart[cell];
+    }
+    if (!fill)
+        return;
+
+    grid.horizontals.resize(grid.horizontalStart[cells]);
+    grid.verticals.resize(grid.verticalStart[cells]);
+    std::vector<std::size_t>
+            horizontalPos(grid.horizontalStart.begin(), grid.horizontalStart.end() - 1),
+            verticalPos(grid.verticalStart.begin(), grid.verticalStart.end() - 1);
+    for (uint32_t i = 0; i < segments.size(); i++)
+    {
+        auto &s = segments[i];
+        if (s.orientation() == Segment::Orientation::HORIZONTAL)
+            forCells(s, [&]( std::size_t cell ) { grid.horizontals[horizontalPos[cell]++] = i; });
+        else
+            forCells(s, [&]( std::size_t cell ) { grid.verticals[verticalPos[cell]++] = i; });
+    }
+}
+
+void GridIntersector::findIntersections( std::vector<Segment> const &segments, ThreadPool *pool,
+                                         std::vector<std::vector<Intersection>> &parts )
+{
+    Grid grid;
+    build(segments, grid, true);
+
+    std::size_t
+            cells = grid.columns * grid.rows,
+            tasks = (cells + cellsPerTask - 1) / cellsPerTask;
+    parts.assign(tasks, std::vector<Intersection>());
+
+    // collinear pairs may share several cells, the one holding start of
+    // common part reports them; id1 is the later one in sweep order
+    auto reportOverlap = [&]( std::vector<Intersection> &part, uint32_t i, uint32_t j )
+    {
+        auto &a = segments[i], &b = segments[j];
+        bool has_intersect;
+        Point start = a.intersect(b, has_intersect);
+        if (!has_intersect)
+            return;
+        bool horizontal = a.orientation() == Segment::Orientation::HORIZONTAL;
+        Point end = horizontal ?
+                    Point(std::min(a.p1().x, b.p1().x), start.y) :
+                    Point(start.x, std::min(a.p1().y, b.p1().y));
+        bool aLater = start == a.p0() && (!(start == b.p0()) || i > j);
+        part.push_back(aLater ? Intersection{a.id(), b.id(), start, end} :
+                                Intersection{b.id(), a.id(), start, end});
+    };
+
+    auto task = [&]( std::size_t t )
+    {
+        auto &part = parts[t];
+        for (std::size_t cell = t * cellsPerTask, end = std::min(cells, cell + cellsPerTask);
+             cell < end; cell++)
+        {
+            std::size_t row = cell / grid.columns, column = cell % grid.columns;
+            for (std::size_t h = grid.horizontalStart[cell]; h < grid.horizontalStart[cell + 1]; h++)
+                for (std::size_t g = grid.horizontalStart[cell]; g < h; g++)
+                {
+                    uint32_t i = grid.horizontals[h], j = grid.horizontals[g];
+                    auto &a = segments[i], &b = segments[j];
+                    if (a.p0().y == b.p0().y &&
+                        grid.column(std::max(a.p0().x, b.p0().x)) == column)
+                        reportOverlap(part, i, j);
+                }
+            for (std::size_t v = grid.verticalStart[cell]; v < grid.verticalStart[cell + 1]; v++)
+                for (std::size_t u = grid.verticalStart[cell]; u < v; u++)
+                {
+                    uint32_t i = grid.verticals[v], j = grid.verticals[u];
+                    auto &a = segments[i], &b = segments[j];
+                    if (a.p0().x == b.p0().x &&
+                        grid.row(std::max(a.p0().y, b.p0().y)) == row)
+                        reportOverlap(part, i, j);
+                }
+            for (std::size_t v = grid.verticalStart[cell]; v < grid.verticalStart[cell + 1]; v++)
+            {
+                auto &vertical = segments[grid.verticals[v]];
+                for (std::size_t h = grid.horizontalStart[cell]; h < grid.horizontalStart[cell + 1]; h++)
+                {
+                    auto &horizontal = segments[grid.horizontals[h]];
+                    bool has_intersect;
+                    auto intPt = vertical.intersect(horizontal, has_intersect);
+                    if (has_intersect)
+                        part.push_back({vertical.id(), horizontal.id(), intPt});
+                }
+            }
+        }
+    };
+
+    if (pool)
+        pool->run(tasks, task);
+    else
+        for (std::size_t t = 0; t < tasks; t++)
+            task(t);
+}
+
+bool GridIntersector::isPreferable( std::vector<Segment> const &segments )
+{
+    Grid grid;
+    build(segments, grid, false);
+
+    // grid does a pass per cell list entry and a test per candidate pair,
+    // sweep sorts events and does a status update or query per event
+    std::size_t cells = grid.columns * grid.rows;
+    double candidates = 0, entries = double(grid.horizontalStart[cells] + grid.verticalStart[cells]);
+    for (std::size_t cell = 0; cell < cells; cell++)
+    {
+        double
+                h = double(grid.horizontalStart[cell + 1] - grid.horizontalStart[cell]),
+                v = double(grid.verticalStart[cell + 1] - grid.verticalStart[cell]);
+        // crossing pairs and collinear candidate pairs
+        candidates += h * v + (h * (h - 1) + v * (v - 1)) / 2;
+    }
+
+    double
+            n = double(segments.size()),
+            sweepCost = n * std::log2(n + 2),
+            gridCost = entries + candidates;
+    return gridCost < sweepCost;
+}
@@ -0,0 +1,116 @@
+#ifndef GRID_INTERSECTOR_H
+#define GRID_INTERSECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "primitives.h"
+#include "intersection_sink.h"
+#include "thread_pool.h"
+
+/*!
+ * \brief The GridIntersector class
+ * \details Uniform grid alternative to sweep of Intersector for short,
+ * \details evenly spread segments: horizontal and vertical segments are
+ * \details bucketed into grid cells and candidates are tested cell by cell.
+ * \details Horizontal segment lies in one row and vertical one in one
+ * \details column, so a crossing pair shares at most one cell and is never
+ * \details tested twice. Collinear pairs may share several cells and are
+ * \details reported by the one holding start of their common part.
+ * \details Finds the same intersections as Intersector; they come
+ * \details ordered by cell (row by row), the same for any number of threads.
+ */
+class GridIntersector
+{
+public:
+    /*!
+     * \brief Compute intersections function.
+     * \param segments Segment list.
+     * \param os output stream.
+     * \param pool Thread pool, may be null.
+     */
+    void computeIntersections( std::vector<Segment> const &segments, std::ostream *os,
+                               ThreadPool *pool = nullptr );
+
+    /*!
+     * \brief Compute intersections function.
+     * \param segments Segment list.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     * \param pool Thread pool, may be null.
+     */
+    template<class Sink>
+    void computeIntersections( std::vector<Segment> const &segments, Sink &sink,
+                               ThreadPool *pool = nullptr );
+
+    /*!
+     * \brief Choose grid or sweep function.
+     * \details Counts candidate pairs grid would test, without testing them,
+     * \details and compares it with cost of sweep.
+     * \param segments Segment list.
+     * \return true if grid is expected to be faster than sweep.
+     */
+    static bool isPreferable( std::vector<Segment> const &segments );
+
+private:
+    /*!
+     * \brief The Grid struct
+     * \details Cells in row major order, horizontal and vertical segment
+     * \details indices of every cell in compressed lists.
+     */
+    struct Grid
+    {
+        double minX, minY, inverseCellSize;
+        std::size_t columns, rows;
+        //! Start of cell lists, per cell plus one
+        std::vector<std::size_t> horizontalStart, verticalStart;
+        std::vector<uint32_t> horizontals, verticals;
+
+        /*!
+         * \brief Get column of x function.
+         */
+        std::size_t column( Coord x ) const;
+
+        /*!
+         * \brief Get row of y function.
+         */
+        std::size_t row( Coord y ) const;
+    };
+
+    /*!
+     * \brief Choose cell size and bucket segments function.
+     * \details Cell size is mean segment length, increased if needed to
+     * \details keep number of cells within cellsPerSegment * n.
+     * \param segments Segment list.
+     * \param grid[OUT] Grid.
+     * \param fill Fill cell lists, otherwise only list starts are computed.
+     */
+    static void build( std::vector<Segment> const &segments, Grid &grid, bool fill );
+
+    /*!
+     * \brief Find intersections function.
+     * \param segments Segment list.
+     * \param pool Thread pool, may be null.
+     * \param parts[OUT] Intersections of consecutive cell ranges.
+     */
+    static void findIntersections( std::vector<Segment> const &segments, ThreadPool *pool,
+                                   std::vector<std::vector<Intersection>> &parts );
+
+    //! Limit of number of cells per segment
+    static const std::size_t cellsPerSegment;
+    //! Cells per task of thread pool
+    static const std::size_t cellsPerTask;
+};
+
+template<class Sink>
+void GridIntersector::computeIntersections( std::vector<Segment> const &segments, Sink &sink,
+                                            ThreadPool *pool )
+{
+    std::vector<std::vector<Intersection>> parts;
+    findIntersections(segments, pool, parts);
+    for (auto &part : parts)
+        for (auto &inter : part)
+            sink(inter);
+}
+
+#endif // GRID_INTERSECTOR_H
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "intersection_sink.h"
+#include "stats.h"
+
+static_assert(sizeof(Intersection) == 24, "BinarySink record must be 24 bytes");
+
+bool LessIntersection::operator()(const Intersection &lhs, const Intersection &rhs) const
+{
+    // the only thing we need is to detect equal intersections
+    if (lhs.id1 == rhs.id2 && lhs.id2 == rhs.id1)
+        return false;
+    // Just to make sure that no intersections will be lost
+    return Point(lhs.id1, lhs.id2) < Point(rhs.id1, rhs.id2);
+}
+
+std::ostream &operator<<(std::ostream &os, const Intersection &inter)
+{
+    os << inter.id1 << ' ' << inter.id2 << ' ' << inter.intPt;
+    if (!(inter.intEnd == inter.intPt))
+        os << ' ' << inter.intEnd;
+    os << '\n';
+    return os;
+}
+
+/*!
+ * \brief Format integer function.
+ * \return Position past last digit.
+ */
+static char * formatInt( char *out, long long value )
+{
+    unsigned long long u = static_cast<unsigned long long>(value);
+    if (value < 0)
+    {
+        *out++ = '-';
+        u = 0 - u;
+    }
+    char digits[24];
+    int n = 0;
+    do
+    {
+        digits[n++] = static_cast<char>('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    while (n > 0)
+        *out++ = digits[--n];
+    return out;
+}
+
+/*!
+ * \brief Format float as default ostream does (%g, 6 digits) function.
+ * \return Position past last character.
+ */
+static char * formatFloat( char *out, float value )
+{
+    // integers below 1e6 are printed by %g exactly as integers
+    if (value == std::trunc(value) && std::fabs(value) < 1e6f && !(value == 0 && std::signbit(value)))
+        return formatInt(out, static_cast<long long>(value));
+    return out + std::snprintf(out, 32, "%g", static_cast<double>(value));
+}
+
+/* Coordinate formatting by coordinate type */
+static inline char * formatCoordinate( char *out, float value )
+{
+    return formatFloat(out, value);
+}
+
+static inline char * formatCoordinate( char *out, int32_t value )
+{
+    return formatInt(out, value);
+}
+
+const std::ptrdiff_t TextSink::maxLineLength;
+
+TextSink::TextSink( std::ostream &os, std::size_t bufferSize ) :
+    os(&os), buffer(std::max<std::size_t>(bufferSize, maxLineLength)), lines(0)
+{
+    pos = buffer.data();
+    end = pos + buffer.size();
+}
+
+TextSink::~TextSink()
+{
+    flush();
+}
+
+void TextSink::flush()
+{
+    STATS_PHASE("output");
+    STATS_ADD("intersections_emitted", lines);
+    os->write(buffer.data(), pos - buffer.data());
+    pos = buffer.data();
+    lines = 0;
+}
+
+char *TextSink::format( char *out, Intersection const &inter )
+{
+    out = formatInt(out, inter.id1);
+    *out++ = ' ';
+    out = formatInt(out, inter.id2);
+    *out++ = ' ';
+    out = formatCoordinate(out, inter.intPt.x);
+    *out++ = ' ';
+    out = formatCoordinate(out, inter.intPt.y);
+    if (!(inter.intEnd == inter.intPt))
+    {
+        *out++ = ' ';
+        out = formatCoordinate(out, inter.intEnd.x);
+        *out++ = ' ';
+        out = formatCoordinate(out, inter.intEnd.y);
+    }
+    *out++ = '\n';
+    return out;
+}
+
+BinarySink::BinarySink( std::ostream &os, std::size_t bufferRecords ) : os(&os)
+{
+    records.reserve(std::max<std::size_t>(bufferRecords, 1));
+}
+
+BinarySink::~BinarySink()
+{
+    flush();
+}
+
+void BinarySink::flush()
+{
+    STATS_PHASE("output");
+    STATS_ADD("intersections_emitted", records.size());
+    os->write(reinterpret_cast<char const *>(records.data()),
+              static_cast<std::streamsize>(records.size() * sizeof(Intersection)));
+    records.clear();
+}
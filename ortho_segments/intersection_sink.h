@@ -0,0 +1,196 @@
+#ifndef INTERSECTION_SINK_H
+#define INTERSECTION_SINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "primitives.h"
+
+/*!
+ * \brief The Intersection struct
+ * \details Common part of two segments: a point or, for collinear
+ * \details overlapping segments, a segment from intPt to intEnd.
+ */
+struct Intersection
+{
+    Intersection() {}
+
+    /*!
+     * \brief Point intersection class constructor.
+     */
+    Intersection( int id1, int id2, Point const &intPt ) :
+        id1(id1), id2(id2), intPt(intPt), intEnd(intPt) {}
+
+    /*!
+     * \brief Overlap class constructor.
+     */
+    Intersection( int id1, int id2, Point const &intPt, Point const &intEnd ) :
+        id1(id1), id2(id2), intPt(intPt), intEnd(intEnd) {}
+
+    //! identifiers of intersected segments
+    int id1, id2;
+    //! Intersection point, lower left end of overlap
+    Point intPt;
+    //! Upper right end of overlap, intPt for point intersections
+    Point intEnd;
+};
+
+std::ostream & operator<<( std::ostream &os, Intersection const& inter );
+
+class LessIntersection
+{
+public:
+    bool operator()( Intersection const &lhs,
+                     Intersection const &rhs ) const;
+};
+
+/*
+ * Intersection sinks.
+ * Sink is any object callable as sink(Intersection const &); sweeps are
+ * templated on sink type, so the call is inlined into the sweep loop.
+ */
+
+/*!
+ * \brief The VectorSink class
+ * \details Appends intersections to vector.
+ */
+class VectorSink
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param intersections Vector to append to.
+     */
+    explicit VectorSink( std::vector<Intersection> &intersections ) :
+        intersections(&intersections) {}
+
+    void operator()( Intersection const &inter )
+    {
+        intersections->push_back(inter);
+    }
+
+private:
+    std::vector<Intersection> *intersections;
+};
+
+/*!
+ * \brief The CountSink class
+ * \details Only counts intersections, may be used as null sink.
+ */
+class CountSink
+{
+public:
+    void operator()( Intersection const & )
+    {
+        n++;
+    }
+
+    /*!
+     * \brief Get number of intersections function.
+     * \return Number of intersections passed to sink.
+     */
+    uint64_t count() const
+    {
+        return n;
+    }
+
+private:
+    uint64_t n = 0;
+};
+
+/*!
+ * \brief The TextSink class
+ * \details Formats intersections as "id1 id2 x y" lines, overlaps as
+ * \details "id1 id2 x y x_end y_end", the same text operator<< gives with
+ * \details default stream settings, into buffer that
+ * \details is written to stream when full. Buffer is flushed on destruction.
+ */
+class TextSink
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param os Output stream.
+     * \param bufferSize Buffer size in bytes.
+     */
+    explicit TextSink( std::ostream &os, std::size_t bufferSize = 1 << 20 );
+
+    TextSink( TextSink const & ) = delete;
+    TextSink & operator=( TextSink const & ) = delete;
+
+    ~TextSink();
+
+    void operator()( Intersection const &inter )
+    {
+        if (end - pos < maxLineLength)
+            flush();
+        pos = format(pos, inter);
+        lines++;
+    }
+
+    /*!
+     * \brief Write buffered text to stream function.
+     */
+    void flush();
+
+private:
+    /*!
+     * \brief Format intersection function.
+     * \param out Buffer with at least maxLineLength bytes free.
+     * \param inter Intersection.
+     * \return Position past formatted line.
+     */
+    static char * format( char *out, Intersection const &inter );
+
+    static const std::ptrdiff_t maxLineLength = 160;
+
+    std::ostream *os;
+    std::vector<char> buffer;
+    char *pos, *end;
+    //! Number of lines in buffer
+    uint64_t lines;
+};
+
+/*!
+ * \brief The BinarySink class
+ * \details Writes intersections as raw 24 byte records: int32 id1,
+ * \details int32 id2, x, y, x_end, y_end of coordinate type (float32 by
+ * \details default, see coordinate.h; end is x, y for point intersections)
+ * \details in native (little endian) byte order, without header. Records
+ * \details are buffered and written in blocks, buffer is flushed on
+ * \details destruction.
+ */
+class BinarySink
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param os Output stream, should be opened in binary mode.
+     * \param bufferRecords Buffer size in records.
+     */
+    explicit BinarySink( std::ostream &os, std::size_t bufferRecords = 1 << 16 );
+
+    BinarySink( BinarySink const & ) = delete;
+    BinarySink & operator=( BinarySink const & ) = delete;
+
+    ~BinarySink();
+
+    void operator()( Intersection const &inter )
+    {
+        if (records.size() == records.capacity())
+            flush();
+        records.push_back(inter);
+    }
+
+    /*!
+     * \brief Write buffered records to stream function.
+     */
+    void flush();
+
+private:
+    std::ostream *os;
+    std::vector<Intersection> records;
+};
+
+#endif // INTERSECTION_SINK_H
@@ -1,151 +1,411 @@
 #include <cassert>
+#include <cstring>
 #include <algorithm>
-#include <set>
 #include <iostream>
 #include <cmath>
 #include "intersector.h"
+#include "fenwick_tree.h"
+#include "radix_sort.h"
 
-void Intersector::computeIntersections( const std::vector<Segment> &segments, std::ostream *os )
+const size_t Intersector::minSlabSize = 1 << 14;
+const size_t Intersector::slabsPerThread = 4;
+const size_t Intersector::boundarySampleSize = 1 << 16;
+
+Intersector::Intersector() : segments(nullptr), activeStatus(active), columnX(0) {}
+
+void Intersector::computeIntersections( const std::vector<Segment> &segments, std::ostream *os,
+                                        ThreadPool *pool )
+{
+    TextSink sink(*os);
+    computeIntersections(segments, sink, pool);
+}
+
+bool Intersector::sweepSlabs( std::vector<Segment> const &segments, ThreadPool &pool,
+                              std::vector<std::vector<Intersection>> &slabResults )
 {
-    this->os = os;
-    for (auto &s: segments)
+    // only horizontals and verticals go to slabs
+    size_t orthogonal = static_cast<size_t>(std::count_if(segments.begin(), segments.end(),
+                                                          []( Segment const &s )
     {
-        events.push_back({s.p0(), s, Event::EndType::LEFT_LOW});
-        // we need only one event corresponding to vertical segment
+        return s.orientation() != Segment::Orientation::NONE;
+    }));
+    size_t slabCount = std::min<size_t>(pool.size() * slabsPerThread, orthogonal / minSlabSize);
+    if (pool.size() < 2 || slabCount < 2)
+        return false;
+
+    // boundaries are quantiles of event x taken from strided sample
+    std::vector<Coord> sample;
+    size_t step = std::max<size_t>(1, segments.size() / boundarySampleSize);
+    for (size_t i = 0; i < segments.size(); i += step)
+    {
+        auto &s = segments[i];
+        if (s.orientation() == Segment::Orientation::NONE)
+            continue;
+        sample.push_back(s.p0().x);
         if (s.orientation() == Segment::Orientation::HORIZONTAL)
-            events.push_back({s.p1(), s, Event::EndType::RIGHT_UP});
+            sample.push_back(s.p1().x);
     }
+    if (sample.size() < slabCount)
+        return false;
+    std::sort(sample.begin(), sample.end());
 
-    std::sort(events.begin(), events.end(),
-              []( Event const &lhs, Event const &rhs )
+    // slab k is [bounds[k - 1], bounds[k]), outer slabs are unbounded
+    std::vector<Coord> bounds;
+    for (size_t k = 1; k < slabCount; k++)
     {
-        return LessEvent()(lhs, rhs);
-    });
+        Coord b = sample[k * sample.size() / slabCount];
+        if (bounds.empty() || b > bounds.back())
+            bounds.push_back(b);
+    }
+    if (bounds.empty())
+        return false;
+    slabCount = bounds.size() + 1;
 
-    for (auto &event : events)
-        processEvent(event);
+    // phases of slabs would add up, the whole parallel sweep is timed
+    STATS_PHASE("sweep");
+    slabResults.assign(slabCount, std::vector<Intersection>());
+    pool.run(slabCount, [&]( size_t k )
+    {
+        STATS_MUTE();
+        bool
+                hasLeft = k > 0,
+                hasRight = k + 1 < slabCount;
+        Coord
+                left = hasLeft ? bounds[k - 1] : 0,
+                right = hasRight ? bounds[k] : 0;
+
+        // verticals inside slab and horizontals overlapping it; input order
+        // is kept, so ties are broken the same way as in sequential sweep
+        std::vector<Segment> slab;
+        for (auto &s : segments)
+        {
+            Coord x0 = s.p0().x, x1 = s.p1().x;
+            switch (s.orientation())
+            {
+            case Segment::Orientation::VERTICAL:
+                if ((!hasLeft || x0 >= left) && (!hasRight || x0 < right))
+                    slab.push_back(s);
+                break;
+            case Segment::Orientation::HORIZONTAL:
+                if ((!hasLeft || x1 >= left) && (!hasRight || x0 < right))
+                    slab.push_back(s);
+                break;
+            default:
+                break;
+            }
+        }
 
+        // overlaps of horizontals are found at the later left end, slabs
+        // after its one have both segments as well and skip them
+        auto &results = slabResults[k];
+        auto sink = [&]( Intersection const &inter )
+        {
+            if (!hasLeft || !(inter.intPt.x < left))
+                results.push_back(inter);
+        };
+        Intersector intersector;
+        intersector.computeIntersections(slab, sink);
+    });
+    return true;
 }
 
-Intersector::EventMap Intersector::getSegmentByLeftEnd(const std::vector<Segment> &segments) const
+uint64_t Intersector::countIntersections( std::vector<Segment> const &segments,
+                                          std::vector<uint32_t> *perSegment,
+                                          ThreadPool *pool )
 {
-    EventMap segmentsByPt;
+    this->segments = &segments;
+    buildEvents(segments, pool);
 
+    std::vector<Coord> ys;
     for (auto &s : segments)
+        if (s.orientation() == Segment::Orientation::HORIZONTAL)
+            ys.push_back(s.p0().y);
+    std::sort(ys.begin(), ys.end());
+    ys.erase(std::unique(ys.begin(), ys.end()), ys.end());
+
+    if (perSegment)
+        perSegment->assign(segments.size(), 0);
+
+    // number of active horizontals by y rank
+    FenwickTree<int64_t> activeCount(ys.size());
+    // verticals passed so far covering y rank, as difference array
+    FenwickTree<int64_t> covered(perSegment ? ys.size() + 1 : 0);
+    // active and ever started horizontals of y rank, for collinear overlaps
+    std::vector<uint32_t> activeAt(ys.size(), 0), startedAt(perSegment ? ys.size() : 0, 0);
+    // events past verticals of the last x counted
+    std::size_t columnEnd = 0;
+
+    STATS_PHASE("sweep");
+    uint64_t total = 0;
+    for (std::size_t e = 0; e < events.size(); e++)
     {
+        auto &event = events[e];
+        auto &s = segments[event.segment];
         if (s.orientation() == Segment::Orientation::HORIZONTAL)
         {
-            Event event = {s.p0(), s, Event::EndType::LEFT_LOW};
-            segmentsByPt[event].insert(s);
+            std::size_t rank = static_cast<std::size_t>(
+                        std::lower_bound(ys.begin(), ys.end(), s.p0().y) - ys.begin());
+            bool left = event.type == Event::EndType::LEFT_LOW;
+            activeCount.add(rank, left ? 1 : -1);
+
+            // starting horizontal overlaps active ones of its y, and
+            // horizontal gets ones of its y started while it was active
+            if (left)
+            {
+                total += activeAt[rank];
+                if (perSegment)
+                    (*perSegment)[event.segment] += activeAt[rank] - ++startedAt[rank];
+                activeAt[rank]++;
+            }
+            else
+            {
+                activeAt[rank]--;
+                if (perSegment)
+                    (*perSegment)[event.segment] += startedAt[rank];
+            }
+            // horizontal gets verticals passed while it was active
+            if (perSegment)
+            {
+                auto passed = static_cast<uint32_t>(covered.prefix(rank + 1));
+                if (left)
+                    (*perSegment)[event.segment] -= passed;
+                else
+                    (*perSegment)[event.segment] += passed;
+            }
+        }
+        else
+        {
+            std::size_t
+                    lo = static_cast<std::size_t>(
+                        std::lower_bound(ys.begin(), ys.end(), s.p0().y) - ys.begin()),
+                    hi = static_cast<std::size_t>(
+                        std::upper_bound(ys.begin(), ys.end(), s.p1().y) - ys.begin());
+            auto count = static_cast<uint64_t>(activeCount.prefix(hi) - activeCount.prefix(lo));
+            total += count;
+            if (perSegment)
+            {
+                (*perSegment)[event.segment] += static_cast<uint32_t>(count);
+                covered.add(lo, 1);
+                covered.add(hi, -1);
+            }
+
+            if (e >= columnEnd)
+                total += countColumn(segments, e, columnEnd, perSegment);
         }
     }
+    STATS_ADD("events_processed", events.size());
 
-    return segmentsByPt;
+    events.clear();
+    events.shrink_to_fit();
+    return total;
 }
 
-Intersector::EventMap Intersector::getSegmentByRightEnd(const std::vector<Segment> &segments) const
+uint64_t Intersector::countColumn( std::vector<Segment> const &segments, std::size_t first,
+                                  std::size_t &last, std::vector<uint32_t> *perSegment ) const
 {
-    EventMap segmentsByPt;
+    Coord x = segments[events[first].segment].p0().x;
+    for (last = first; last < events.size(); last++)
+    {
+        auto &s = segments[events[last].segment];
+        if (s.orientation() != Segment::Orientation::VERTICAL || s.p0().x != x)
+            break;
+    }
+    std::size_t m = last - first;
+    if (m < 2)
+        return 0;
 
-    for (auto &s : segments)
+    // lower ends are ascending; a vertical ending below lower end of
+    // another one comes before it
+    std::vector<Coord> low(m), high(m);
+    for (std::size_t i = 0; i < m; i++)
     {
-        if (s.orientation() == Segment::Orientation::HORIZONTAL)
+        auto &s = segments[events[first + i].segment];
+        low[i] = s.p0().y;
+        high[i] = s.p1().y;
+    }
+    std::vector<Coord> sortedHigh(high);
+    std::sort(sortedHigh.begin(), sortedHigh.end());
+
+    uint64_t total = 0;
+    for (std::size_t i = 0; i < m; i++)
+    {
+        auto earlier = static_cast<uint64_t>(
+                    i - (std::lower_bound(sortedHigh.begin(), sortedHigh.end(), low[i]) - sortedHigh.begin()));
+        total += earlier;
+        if (perSegment)
         {
-            Event event = {s.p1(), s, Event::EndType::RIGHT_UP};
-            segmentsByPt[event].insert(s);
+            auto later = static_cast<uint64_t>(
+                        (std::upper_bound(low.begin(), low.end(), high[i]) - low.begin()) - (i + 1));
+            (*perSegment)[events[first + i].segment] += static_cast<uint32_t>(earlier + later);
         }
     }
-
-    return segmentsByPt;
+    return total;
 }
 
-void Intersector::fillStatus( Event const &event )
-{
-    if (event.type == Event::EndType::LEFT_LOW &&
-        event.segment.orientation() == Segment::Orientation::HORIZONTAL)
-        status.insert(event.segment);
-    else if (event.type == Event::EndType::RIGHT_UP)
-        status.erase(event.segment);
-}
-
-
-void Intersector::processEvent( Event const &event )
+void Intersector::buildEvents( std::vector<Segment> const &segments, ThreadPool *pool )
 {
-    fillStatus(event);
-
-    // find intersection
-    if (event.segment.orientation() == Segment::Orientation::VERTICAL)
+    static const size_t minChunkSize = 1 << 16;
+    size_t
+            n = segments.size(),
+            chunks = pool ? std::max<size_t>(1, std::min<size_t>(pool->size(), n / minChunkSize)) : 1;
+    auto eventCount = []( Segment const &s ) -> size_t
     {
-        auto pt1 = event.segment.p1();
-        Point pt2 = {pt1.x + 1, pt1.y};
-        Segment hlp_up(pt1, pt2, 0);
-
-        pt1 = event.segment.p0();
-        pt2 = {pt1.x + 1, pt1.y};
-        Segment hlp_low(pt1, pt2, 0);
+        // we need only one event corresponding to vertical segment
+        switch (s.orientation())
+        {
+        case Segment::Orientation::HORIZONTAL:
+            return 2;
+        case Segment::Orientation::VERTICAL:
+            return 1;
+        default:
+            return 0;
+        }
+    };
+    auto forChunks = [&]( std::function<void( size_t )> const &task )
+    {
+        if (chunks > 1)
+            pool->run(chunks, task);
+        else
+            task(0);
+    };
 
-        // find all horizontal segments that intersect vertical...
-        auto
-                low_seg_it = status.lower_bound(hlp_low),
-                up_seg_it = status.upper_bound(hlp_up);
+    {
+        STATS_PHASE("event_build");
 
-        // TODO ??? ++up_seg_it
-        for (auto it = low_seg_it; it != status.end() && it != up_seg_it; it++)
+        // events of chunk are placed after events of previous chunks, so
+        // events are listed in input order
+        std::vector<size_t> offsets(chunks + 1, 0);
+        forChunks([&]( size_t c )
         {
-            bool has_intersect;
-            auto intPt = event.segment.intersect(*it, has_intersect);
-            assert(has_intersect);
-            *os << Intersection{event.segment.id(), it->id(), intPt};
-        }
+            size_t count = 0;
+            for (size_t i = n * c / chunks, end = n * (c + 1) / chunks; i < end; i++)
+                count += eventCount(segments[i]);
+            offsets[c + 1] = count;
+        });
+        for (size_t c = 0; c < chunks; c++)
+            offsets[c + 1] += offsets[c];
 
-        // ... and find vertical segments that have common end point with current TODO
+        events.resize(offsets[chunks]);
+        forChunks([&]( size_t c )
+        {
+            Event *out = events.data() + offsets[c];
+            for (size_t i = n * c / chunks, end = n * (c + 1) / chunks; i < end; i++)
+            {
+                auto &s = segments[i];
+                auto index = static_cast<uint32_t>(i);
+                size_t count = eventCount(s);
+                if (count > 0)
+                    *out++ = {Event::makeKey(s, Event::EndType::LEFT_LOW), index, Event::EndType::LEFT_LOW};
+                if (count > 1)
+                    *out++ = {Event::makeKey(s, Event::EndType::RIGHT_UP), index, Event::EndType::RIGHT_UP};
+            }
+        });
     }
-}
 
-LessSegment::LessSegment( Event const &event ) : event(event) {}
+    STATS_PHASE("sort");
+    radixSort(events, []( Event const &event ) { return event.key; }, pool);
+}
 
-bool LessSegment::operator()(const Segment &lhs, const Segment &rhs)
+void Intersector::clearActive()
 {
-    assert(lhs.orientation() == Segment::Orientation::HORIZONTAL);
-    assert(rhs.orientation() == Segment::Orientation::HORIZONTAL);
-    return lhs.p0().y < rhs.p0().y;
+    active.clear();
+    freeSlots.clear();
+    activeStatus.clear();
+    activeEnds = decltype(activeEnds)();
+    columnEnds.clear();
 }
 
-bool LessEvent::operator()(const Event &lhs, const Event &rhs)
+void Intersector::expireActive( Coord x )
 {
-    if (std::fabs(lhs.pt.x - rhs.pt.x) < Segment::tolerance)
+    // right ends strictly left of x are passed
+    while (!activeEnds.empty() && activeEnds.top().first < x)
     {
-        if (lhs.segment.orientation() == Segment::Orientation::HORIZONTAL &&
-            rhs.segment.orientation() == Segment::Orientation::VERTICAL)
-            return lhs.type == Event::EndType::LEFT_LOW;
-        if (lhs.segment.orientation() == Segment::Orientation::VERTICAL &&
-            rhs.segment.orientation() == Segment::Orientation::HORIZONTAL)
-            return rhs.type == Event::EndType::RIGHT_UP;
+        uint32_t slot = activeEnds.top().second;
+        activeStatus.erase(slot);
+        freeSlots.push_back(slot);
+        activeEnds.pop();
     }
+}
 
-    if (lhs.pt == rhs.pt &&
-            lhs.segment.orientation() == Segment::Orientation::HORIZONTAL &&
-            rhs.segment.orientation() == Segment::Orientation::HORIZONTAL)
+void Intersector::activate( Segment const &horizontal )
+{
+    uint32_t slot;
+    if (freeSlots.empty())
     {
-        if (!(lhs.segment == rhs.segment))
-        /* configuration -- */
-            return lhs.type == Event::EndType::RIGHT_UP;
-        return false;
+        slot = static_cast<uint32_t>(active.size());
+        active.push_back(horizontal);
+    }
+    else
+    {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+        active[slot] = horizontal;
     }
-    return lhs.pt < rhs.pt;
+    activeStatus.insert(slot);
+    activeEnds.push({horizontal.p1().x, slot});
 }
 
-bool LessIntersection::operator()(const Intersection &lhs, const Intersection &rhs) const
+/*!
+ * \brief Map float to unsigned preserving order function.
+ * \details Negative zero is mapped as positive one, NaN is not expected.
+ */
+static inline uint32_t orderedBits( float value )
 {
-    // the only thing we need is to detect equal intersections
-    if (lhs.id1 == rhs.id2 && lhs.id2 == rhs.id1)
-        return false;
-    // Just to make sure that no intersections will be lost
-    return Point(lhs.id1, lhs.id2) < Point(rhs.id1, rhs.id2);
+    value += 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+/*!
+ * \brief Map integer to unsigned preserving order function.
+ */
+static inline uint32_t orderedBits( int32_t value )
+{
+    return static_cast<uint32_t>(value) ^ 0x80000000u;
 }
 
-std::ostream &operator<<(std::ostream &os, const Intersection &inter)
+uint64_t Event::makeKey( Segment const &segment, EndType type )
 {
-    os << inter.id1 << ' ' << inter.id2 << ' ' << inter.intPt << '\n';
-    return os;
+    uint64_t x = orderedBits(type == EndType::LEFT_LOW ? segment.p0().x : segment.p1().x);
+    uint32_t rank;
+    if (segment.orientation() == Segment::Orientation::VERTICAL)
+        // ordered bits of finite y are never 0 nor all ones (see coordinate.h)
+        rank = orderedBits(segment.p0().y);
+    else
+        rank = type == EndType::LEFT_LOW ? 0 : 0xFFFFFFFFu;
+    return (x << 32) | rank;
+}
+
+LessEvent::LessEvent( std::vector<Segment> const &segments ) : segments(&segments) {}
+
+bool LessEvent::operator()(const Event &lhs_event, const Event &rhs_event) const
+{
+    auto
+            &lhs = (*segments)[lhs_event.segment],
+            &rhs = (*segments)[rhs_event.segment];
+    auto
+            lhs_pt = lhs_event.type == Event::EndType::LEFT_LOW ? lhs.p0() : lhs.p1(),
+            rhs_pt = rhs_event.type == Event::EndType::LEFT_LOW ? rhs.p0() : rhs.p1();
+
+    if (lhs_pt.x != rhs_pt.x)
+        return lhs_pt.x < rhs_pt.x;
+
+    // at the same x: left ends of horizontals, verticals, right ends of horizontals
+    auto priority = []( Segment const &s, Event const &e )
+    {
+        if (s.orientation() == Segment::Orientation::VERTICAL)
+            return 1;
+        return e.type == Event::EndType::LEFT_LOW ? 0 : 2;
+    };
+    int
+            lhs_priority = priority(lhs, lhs_event),
+            rhs_priority = priority(rhs, rhs_event);
+    if (lhs_priority != rhs_priority)
+        return lhs_priority < rhs_priority;
+
+    // order of horizontal ends at the same x does not affect output
+    if (lhs_priority == 1 && lhs_pt.y != rhs_pt.y)
+        return lhs_pt.y < rhs_pt.y;
+    return lhs_event.segment < rhs_event.segment;
 }
@@ -1,102 +1,466 @@
 #ifndef INTERSECTOR_H
 #define INTERSECTOR_H
 
-#include <map>
-#include <set>
+#include <cassert>
+#include <cstdint>
+#include <queue>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
 #include "primitives.h"
+#include "sweep_status.h"
+#include "stats.h"
+#include "intersection_sink.h"
+#include "thread_pool.h"
 
+/*!
+ * \brief The Event struct
+ * \details Compact sweep event: sort key, index of segment in input and
+ * \details end type.
+ */
 struct Event
 {
-    Point pt;
-    // pt is left or right end of segment
-    Segment segment;
-    enum class EndType
+    // event point is left or right end of segment
+    enum class EndType : uint32_t
     {
         LEFT_LOW, RIGHT_UP
-    } type;
-};
+    };
 
-class LessSegment
-{
-public:
-    LessSegment() {}
-    LessSegment( Event const &event );
+    /*!
+     * \brief Make sort key function.
+     * \details Key is (x bits << 32 | rank), where bits of coordinate are
+     * \details mapped to unsigned preserving order and rank is 0 for left
+     * \details ends of horizontals, y bits for verticals and all ones for
+     * \details right ends of horizontals. Stable sort by key of events
+     * \details listed in input order gives the order of LessEvent.
+     * \param segment Segment.
+     * \param type End type.
+     * \return Key.
+     */
+    static uint64_t makeKey( Segment const &segment, EndType type );
 
-    bool operator()( Segment const &lhs, Segment const &rhs );
-private:
-    Event event;
+    //! Sort key, see makeKey
+    uint64_t key;
+    //! Index of segment in input list
+    uint32_t segment;
+    EndType type;
 };
 
+/*!
+ * \brief The LessEvent class
+ * \details Comparator giving the same order as Event::key, kept for
+ * \details reference and comparison sorts.
+ */
 class LessEvent
 {
 public:
-    bool operator()( Event const &lhs, Event const &rhs );
+    /*!
+     * \brief Class constructor.
+     * \param segments Segments events refer to.
+     */
+    LessEvent( std::vector<Segment> const &segments );
+
+    bool operator()( Event const &lhs, Event const &rhs ) const;
+private:
+    std::vector<Segment> const *segments;
 };
 
 /*!
- * \brief The Intersection struct
+ * \brief The Intersector class
+ * \details Plane sweep over horizontal and vertical segments. Besides
+ * \details crossings of horizontals and verticals it reports collinear
+ * \details horizontals and verticals having common points, as overlap
+ * \details intervals: a horizontal meets active horizontals of its y when it
+ * \details starts (status query of one y), a vertical meets verticals of its
+ * \details x passed before it whose upper ends are not below its lower end
+ * \details (heap of upper ends of the current x). Both cost O(log n + k).
+ * \details id1 is the segment coming later in sweep order.
  */
-struct Intersection
-{
-    //! identifiers of intersected segments
-    int id1, id2;
-    //! Intersection point
-    Point intPt;
-};
-
-std::ostream & operator<<( std::ostream &os, Intersection const& inter );
-
-class LessIntersection
-{
-public:
-    bool operator()( Intersection const &lhs,
-                     Intersection const &rhs ) const;
-};
-
 class Intersector
 {
 public:
-    using SegmentSet = std::set<Segment, LessSegment>;
-    using EventMap = std::map<Event, SegmentSet, LessEvent>;
+    Intersector();
 
     /*!
      * \brief Compute intersections function.
      * \param segments Segment list.
      * \param os output stream.
+     * \param pool Thread pool for slab parallel sweep, may be null.
+     */
+    void computeIntersections( std::vector<Segment> const &segments, std::ostream *os,
+                               ThreadPool *pool = nullptr );
+
+    /*!
+     * \brief Compute intersections function.
+     * \details With pool of several threads x range is cut into vertical
+     * \details slabs holding about the same number of events, slabs are
+     * \details swept independently and results are passed to sink in slab
+     * \details order, so output is the same as sequential one.
+     * \param segments Segment list.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     * \param pool Thread pool for slab parallel sweep, may be null.
      */
-    void computeIntersections( std::vector<Segment> const &segments, std::ostream *os );
+    template<class Sink>
+    void computeIntersections( std::vector<Segment> const &segments, Sink &sink,
+                               ThreadPool *pool = nullptr );
+
+    /*!
+     * \brief Compute intersections of segment stream function.
+     * \details Segments must come sorted by x of their left (lower) end.
+     * \details Input is swept in one pass; only segments starting at
+     * \details current x and active horizontal segments are kept in memory.
+     * \param first Input iterator to first segment, e.g. std::istream_iterator.
+     * \param last Input iterator past last segment.
+     * \param os output stream.
+     * \return true if ok, false if input turned out not to be sorted.
+     */
+    template<class InputIt>
+    bool computeIntersectionsSorted( InputIt first, InputIt last, std::ostream *os );
+
+    /*!
+     * \brief Compute intersections of segment stream function.
+     * \param first Input iterator to first segment.
+     * \param last Input iterator past last segment.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     * \return true if ok, false if input turned out not to be sorted.
+     */
+    template<class InputIt, class Sink>
+    bool computeIntersectionsSorted( InputIt first, InputIt last, Sink &sink );
+
+    /*!
+     * \brief Count intersections function.
+     * \details Intersections are not enumerated: sweep keeps Fenwick trees
+     * \details over compressed y of horizontal segments, so it takes
+     * \details O(n log n) whatever number of intersections is. Collinear
+     * \details overlaps are counted as well, by active horizontals of every
+     * \details y and by sorted ends of verticals of every x.
+     * \param segments Segment list.
+     * \param perSegment[OUT] If not null, number of intersections of every
+     * \param perSegment segment, by index in segments.
+     * \param pool Thread pool for event sorting, may be null.
+     * \return Total number of intersections.
+     */
+    uint64_t countIntersections( std::vector<Segment> const &segments,
+                                 std::vector<uint32_t> *perSegment = nullptr,
+                                 ThreadPool *pool = nullptr );
+
 private:
     /*!
-     * \brief Get segments list by their left point.
+     * \brief Sweep vertical slabs in parallel function.
+     * \param segments Segment list.
+     * \param pool Thread pool.
+     * \param slabResults[OUT] Intersections found in every slab, left to right.
+     * \return false if horizontals and verticals are too few to split, true otherwise.
+     */
+    static bool sweepSlabs( std::vector<Segment> const &segments, ThreadPool &pool,
+                            std::vector<std::vector<Intersection>> &slabResults );
+
+    //! Minimal number of segments per slab
+    static const size_t minSlabSize;
+    //! Number of slabs per thread, more slabs smooth out uneven density
+    static const size_t slabsPerThread;
+    //! Number of event x values sampled to place slab boundaries
+    static const size_t boundarySampleSize;
+
+    /*!
+     * \brief Count overlaps of verticals of one x function.
      * \param segments Segment list.
-     * \return map: left point -> segment list.
+     * \param first Event of first vertical of the x.
+     * \param last[OUT] Event past last vertical of the x.
+     * \param perSegment[IN, OUT] If not null, overlaps are added to counts
+     * \param perSegment of verticals.
+     * \return Number of overlapping pairs.
      */
-    EventMap getSegmentByLeftEnd( std::vector<Segment> const &segments ) const;
+    uint64_t countColumn( std::vector<Segment> const &segments, std::size_t first,
+                          std::size_t &last, std::vector<uint32_t> *perSegment ) const;
 
     /*!
-     * \brief Get segments list by their right point.
+     * \brief Fill and sort events function.
+     * \details Events are generated and radix sorted by key in parallel.
      * \param segments Segment list.
-     * \return map: right point -> segment list.
+     * \param pool Thread pool, may be null.
      */
-    EventMap getSegmentByRightEnd( std::vector<Segment> const &segments ) const;
+    void buildEvents( std::vector<Segment> const &segments, ThreadPool *pool );
 
     /*!
      * \brief Process sweep line event function.
      * \param[IN] event Event.
+     * \param status Sweep line status.
+     * \param sink Intersection sink.
      */
-    void processEvent( Event const &event );
+    template<class Status, class Sink>
+    void processEvent( Event const &event, Status &status, Sink &sink );
 
     /*!
      * \brief Fill status function.
      * \param event Current event.
+     * \param status Sweep line status.
+     */
+    template<class Status>
+    void fillStatus( Event const &event, Status &status );
+
+    /*!
+     * \brief Report horizontals in status overlapping starting one function.
+     * \details Called before horizontal is inserted; all active horizontals
+     * \details of its y contain its left end.
+     * \param horizontal Horizontal segment.
+     * \param status Sweep line status.
+     * \param horizontals Segments status indices refer to.
+     * \param sink Intersection sink.
+     */
+    template<class Status, class Sink>
+    void reportRow( Segment const &horizontal, Status const &status,
+                    std::vector<Segment> const &horizontals, Sink &sink );
+
+    /*!
+     * \brief Report verticals of the same x overlapping vertical function.
+     * \details Verticals of one x must come by lower end.
+     * \param vertical Vertical segment.
+     * \param index Index of vertical in verticals.
+     * \param verticals Segments column indices refer to.
+     * \param sink Intersection sink.
+     */
+    template<class Sink>
+    void reportColumn( Segment const &vertical, uint32_t index,
+                       std::vector<Segment> const &verticals, Sink &sink );
+
+    /*!
+     * \brief Report horizontal segments in status crossing vertical function.
+     * \param vertical Vertical segment.
+     * \param status Sweep line status.
+     * \param horizontals Segments status indices refer to.
+     * \param sink Intersection sink.
      */
-    void fillStatus( Event const &event );
+    template<class Status, class Sink>
+    void reportVertical( Segment const &vertical, Status const &status,
+                         std::vector<Segment> const &horizontals, Sink &sink );
 
+    /*!
+     * \brief Process segments with common left end x function.
+     * \param group[IN, OUT] Segments starting at the same x, reordered on exit.
+     * \param sink Intersection sink.
+     */
+    template<class Sink>
+    void processGroup( std::vector<Segment> &group, Sink &sink );
+
+    /*!
+     * \brief Expire stream mode horizontals function.
+     * \param x Sweep line x, horizontals ending left of it are expired.
+     */
+    void expireActive( Coord x );
+
+    /*!
+     * \brief Activate stream mode horizontal function.
+     * \param horizontal Horizontal segment.
+     */
+    void activate( Segment const &horizontal );
+
+    /*!
+     * \brief Reset stream mode state function.
+     */
+    void clearActive();
+
+    using ActiveEnd = std::pair<Coord, uint32_t>;
+
+    std::vector<Segment> const *segments;
     std::vector<Event> events;
-    //! Sweep line status
-    SegmentSet status;
 
-    std::ostream *os;
+    //! Active horizontal segments (stream mode), addressed by slot
+    std::vector<Segment> active;
+    //! Free slots of active
+    std::vector<uint32_t> freeSlots;
+    //! Sweep line status over active (stream mode)
+    FlatStatus activeStatus;
+    //! Right end x and slot of active segments (stream mode)
+    std::priority_queue<ActiveEnd, std::vector<ActiveEnd>, std::greater<ActiveEnd>> activeEnds;
+
+    //! x of verticals in column heap
+    Coord columnX;
+    //! Min heap of upper end y and index of verticals passed at columnX
+    std::vector<ActiveEnd> columnEnds;
 };
 
+template<class Sink>
+void Intersector::computeIntersections( std::vector<Segment> const &segments, Sink &sink,
+                                        ThreadPool *pool )
+{
+    std::vector<std::vector<Intersection>> slabResults;
+    if (pool && sweepSlabs(segments, *pool, slabResults))
+    {
+        for (auto &slab : slabResults)
+            for (auto &inter : slab)
+                sink(inter);
+        return;
+    }
+
+    this->segments = &segments;
+    buildEvents(segments, pool);
+    columnEnds.clear();
+
+    {
+        STATS_PHASE("sweep");
+        STATS_ONLY(size_t maxStatus = 0;)
+        CompressedStatus status(segments);
+        for (auto &event : events)
+        {
+            processEvent(event, status, sink);
+            STATS_ONLY(maxStatus = std::max(maxStatus, status.size());)
+        }
+        STATS_ADD("events_processed", events.size());
+        STATS_MAX("max_status_size", maxStatus);
+    }
+
+    events.clear();
+    events.shrink_to_fit();
+}
+
+template<class InputIt>
+bool Intersector::computeIntersectionsSorted( InputIt first, InputIt last, std::ostream *os )
+{
+    TextSink sink(*os);
+    return computeIntersectionsSorted(first, last, sink);
+}
+
+template<class InputIt, class Sink>
+bool Intersector::computeIntersectionsSorted( InputIt first, InputIt last, Sink &sink )
+{
+    clearActive();
+
+    std::vector<Segment> group;
+    for (; first != last; ++first)
+    {
+        Segment s = *first;
+        if (!group.empty())
+        {
+            if (s.p0().x < group.front().p0().x)
+                return false;
+            if (s.p0().x > group.front().p0().x)
+            {
+                processGroup(group, sink);
+                group.clear();
+            }
+        }
+        group.push_back(s);
+    }
+    processGroup(group, sink);
+
+    return true;
+}
+
+template<class Status>
+void Intersector::fillStatus( Event const &event, Status &status )
+{
+    auto &segment = (*segments)[event.segment];
+    if (segment.orientation() != Segment::Orientation::HORIZONTAL)
+        return;
+    if (event.type == Event::EndType::LEFT_LOW)
+        status.insert(event.segment);
+    else
+        status.erase(event.segment);
+}
+
+template<class Status, class Sink>
+void Intersector::processEvent( Event const &event, Status &status, Sink &sink )
+{
+    auto &segment = (*segments)[event.segment];
+    if (segment.orientation() == Segment::Orientation::HORIZONTAL &&
+        event.type == Event::EndType::LEFT_LOW)
+        reportRow(segment, status, *segments, sink);
+
+    fillStatus(event, status);
+
+    // find intersection
+    if (segment.orientation() == Segment::Orientation::VERTICAL)
+    {
+        reportVertical(segment, status, *segments, sink);
+        reportColumn(segment, event.segment, *segments, sink);
+    }
+}
+
+template<class Status, class Sink>
+void Intersector::reportVertical( Segment const &vertical, Status const &status,
+                                  std::vector<Segment> const &horizontals, Sink &sink )
+{
+    // find all horizontal segments that intersect vertical...
+    status.forEach(vertical.p0().y, vertical.p1().y, [&]( uint32_t h )
+    {
+        bool has_intersect;
+        auto intPt = vertical.intersect(horizontals[h], has_intersect);
+        assert(has_intersect);
+        sink(Intersection{vertical.id(), horizontals[h].id(), intPt});
+    });
+}
+
+template<class Status, class Sink>
+void Intersector::reportRow( Segment const &horizontal, Status const &status,
+                             std::vector<Segment> const &horizontals, Sink &sink )
+{
+    // common part starts at the left end of the starting segment
+    Point start = horizontal.p0();
+    status.forEach(start.y, start.y, [&]( uint32_t h )
+    {
+        auto &other = horizontals[h];
+        Point end(std::min(horizontal.p1().x, other.p1().x), start.y);
+        sink(Intersection{horizontal.id(), other.id(), start, end});
+    });
+}
+
+template<class Sink>
+void Intersector::reportColumn( Segment const &vertical, uint32_t index,
+                                std::vector<Segment> const &verticals, Sink &sink )
+{
+    Point start = vertical.p0();
+    if (columnEnds.empty() || columnX != start.x)
+    {
+        columnEnds.clear();
+        columnX = start.x;
+    }
+
+    // verticals passed come with lower ends not above, ones ending below
+    // this one can not meet it nor any following one
+    std::greater<ActiveEnd> later;
+    while (!columnEnds.empty() && columnEnds.front().first < start.y)
+    {
+        std::pop_heap(columnEnds.begin(), columnEnds.end(), later);
+        columnEnds.pop_back();
+    }
+    for (auto &end : columnEnds)
+    {
+        Point last(start.x, std::min(vertical.p1().y, end.first));
+        sink(Intersection{vertical.id(), verticals[end.second].id(), start, last});
+    }
+
+    columnEnds.push_back(ActiveEnd(vertical.p1().y, index));
+    std::push_heap(columnEnds.begin(), columnEnds.end(), later);
+}
+
+template<class Sink>
+void Intersector::processGroup( std::vector<Segment> &group, Sink &sink )
+{
+    if (group.empty())
+        return;
+
+    // left ends go before verticals at the same x, right ends after them
+    expireActive(group.front().p0().x);
+    for (auto &s : group)
+        if (s.orientation() == Segment::Orientation::HORIZONTAL)
+        {
+            reportRow(s, activeStatus, active, sink);
+            activate(s);
+        }
+
+    std::stable_sort(group.begin(), group.end(), []( Segment const &lhs, Segment const &rhs )
+    {
+        return lhs.p0() < rhs.p0();
+    });
+    columnEnds.clear();
+    for (uint32_t i = 0; i < group.size(); i++)
+        if (group[i].orientation() == Segment::Orientation::VERTICAL)
+        {
+            reportVertical(group[i], activeStatus, active, sink);
+            reportColumn(group[i], i, group, sink);
+        }
+}
+
 #endif // INTERSECTOR_H
@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "intersector.h"
+#include "intersection_sink.h"
+#include "thread_pool.h"
+
+namespace
+{
+
+/*!
+ * \brief Make diagonal segments function.
+ * \details Short parallel diagonals, none of them crossing.
+ * \param n Number of segments.
+ * \param firstId Id of first segment.
+ * \return Segments.
+ */
+std::vector<Segment> diagonals( int n, int firstId )
+{
+    std::vector<Segment> segments;
+    for (int i = 0; i < n; i++)
+        segments.emplace_back(Point(static_cast<Coord>(2 * i), 0),
+                              Point(static_cast<Coord>(2 * i + 1), 1), firstId + i);
+    return segments;
+}
+
+/*!
+ * \brief Find intersections sorted by ids function.
+ * \param segments Segment list.
+ * \param pool Thread pool, may be null.
+ * \return Intersections.
+ */
+std::vector<Intersection> intersections( std::vector<Segment> const &segments, ThreadPool *pool )
+{
+    std::vector<Intersection> result;
+    VectorSink sink(result);
+    Intersector intersector;
+    intersector.computeIntersections(segments, sink, pool);
+    std::sort(result.begin(), result.end(), []( Intersection const &lhs, Intersection const &rhs )
+    {
+        return lhs.id1 != rhs.id1 ? lhs.id1 < rhs.id1 : lhs.id2 < rhs.id2;
+    });
+    return result;
+}
+
+/*!
+ * \brief Check parallel sweep finds what sequential one does function.
+ * \param name Case name.
+ * \param segments Segment list.
+ * \return true if results are equal.
+ */
+bool check( char const *name, std::vector<Segment> const &segments )
+{
+    ThreadPool pool(4);
+    auto expected = intersections(segments, nullptr), found = intersections(segments, &pool);
+    bool same = expected.size() == found.size() &&
+            std::equal(expected.begin(), expected.end(), found.begin(),
+                       []( Intersection const &lhs, Intersection const &rhs )
+    {
+        return lhs.id1 == rhs.id1 && lhs.id2 == rhs.id2 &&
+                lhs.intPt == rhs.intPt && lhs.intEnd == rhs.intEnd;
+    });
+    std::clog << name << (same ? ": ok\n" : ": FAILED\n");
+    return same;
+}
+
+} // namespace
+
+int main()
+{
+    // slabs are planned from horizontals and verticals only, input of
+    // diagonals falls back to sequential sweep
+    bool ok = check("diagonals only", diagonals(40000, 0));
+
+    auto mixed = diagonals(40000, 0);
+    mixed.emplace_back(Point(0, 5), Point(100, 5), 40000);
+    mixed.emplace_back(Point(50, 0), Point(50, 10), 40001);
+    ok = check("few orthogonal among diagonals", mixed) && ok;
+
+    // enough horizontals and verticals to be split into slabs
+    auto split = diagonals(1000, 0);
+    for (int i = 0; i < 20000; i++)
+    {
+        auto c = static_cast<Coord>(i);
+        split.emplace_back(Point(c, c), Point(c + 8, c), 1000 + 2 * i);
+        split.emplace_back(Point(c, c - 8), Point(c, c), 1001 + 2 * i);
+    }
+    ok = check("orthogonal with diagonals", split) && ok;
+
+    return ok ? 0 : 1;
+}
@@ -1,51 +1,272 @@
 #include <iostream>
 #include <fstream>
+#include <iterator>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 
 #include "segment_loader.h"
 #include "intersector.h"
+#include "general_intersector.h"
+#include "grid_intersector.h"
+#include "segment_index.h"
+#include "stats.h"
 
 using namespace std;
 
+//! Engine for horizontal and vertical segments
+enum class Engine { SWEEP, GRID, AUTO };
+
 void help()
 {
-    std::clog << "Usage: -i path/to/input/file -o path/to/output/file\n";
+    std::clog << "Usage: -i path/to/input/file -o path/to/output/file [-s | -g] [-e sweep|grid|auto] [-b] [-c | -C] [-t threads]\n"
+                 "       [-x path/to/index/file | -q path/to/probe/file | -w path/to/window/file] [--stats]\n"
+                 "  -s  input is sorted by x of left segment ends, sweep it as a stream\n"
+                 "  -g  segments of any direction (Bentley-Ottmann sweep)\n"
+                 "  -e  engine for horizontal and vertical segments: plane sweep (default),\n"
+                 "      uniform grid or chosen by input\n"
+                 "  -b  write intersections as binary records (int32 id1, id2, 32 bit coordinate\n"
+                 "      x, y, x_end, y_end; end of common part of collinear segments)\n"
+                 "  -c  output number of intersections only\n"
+                 "  -C  output number of intersections and \"id count\" of every segment\n"
+                 "  -t  number of threads, 0 -- all cores (default 1)\n"
+                 "  -x  build index of input segments and save it, input may then be the index\n"
+                 "  -q  intersections of every probe segment with input segments (by index),\n"
+                 "      probe id goes first, probes are answered sorted by their lines\n"
+                 "  -w  \"window_id segment_id\" of input segments meeting every window\n"
+                 "      (windows are given as segments between opposite corners)\n"
+                 "  --stats  print phase times, counters and peak memory as JSON to stderr\n";
+}
+
+/*!
+ * \brief Load segments and sweep them into sink function.
+ * \param inputFileName Input file name.
+ * \param sorted Input is sorted by x of left segment ends.
+ * \param general Segments are of any direction.
+ * \param engine Engine for horizontal and vertical segments.
+ * \param pool Thread pool.
+ * \param sink Intersection sink.
+ */
+template<class Sink>
+void listIntersections( std::string const &inputFileName, bool sorted, bool general,
+                        Engine engine, ThreadPool &pool, Sink &sink )
+{
+    SegmentLoader loader;
+    Intersector intersector;
+
+    if (sorted && !general && engine == Engine::SWEEP && !loader.isBinaryFile(inputFileName))
+    {
+        std::ifstream ifs(inputFileName);
+        if (!ifs)
+        {
+            std::clog << "file " << inputFileName << " not found\n";
+            return;
+        }
+
+        std::istream_iterator<Segment> first(ifs), last;
+        if (!intersector.computeIntersectionsSorted(first, last, sink))
+            std::clog << "input is not sorted by x\n";
+        else if (!ifs.eof())
+            std::clog << "wrong file format\n";
+        return;
+    }
+
+    bool ok;
+    auto segments = loader.loadFromFile(inputFileName, &ok);
+    if (!ok)
+    {
+        std::clog << "Something went wrong while loading input file\n";
+        return;
+    }
+
+    if (general)
+    {
+        GeneralIntersector generalIntersector;
+        generalIntersector.computeIntersections(segments, sink);
+    }
+    else if (engine == Engine::GRID ||
+             (engine == Engine::AUTO && GridIntersector::isPreferable(segments)))
+    {
+        GridIntersector gridIntersector;
+        gridIntersector.computeIntersections(segments, sink, &pool);
+    }
+    else if (sorted)
+    {
+        if (!intersector.computeIntersectionsSorted(segments.begin(), segments.end(), sink))
+            std::clog << "input is not sorted by x\n";
+    }
+    else
+        intersector.computeIntersections(segments, sink, &pool);
+}
+
+/*!
+ * \brief Get index of input file function.
+ * \param inputFileName Input file name, saved index or segment file.
+ * \param index[OUT] Index.
+ * \return true if ok, false otherwise.
+ */
+bool loadIndex( std::string const &inputFileName, SegmentIndex &index )
+{
+    if (SegmentIndex::isIndexFile(inputFileName))
+        return index.load(inputFileName);
+
+    bool ok;
+    auto segments = SegmentLoader::loadFromFile(inputFileName, &ok);
+    if (ok)
+        index.build(segments);
+    return ok;
+}
+
+/*!
+ * \brief Answer probe queries into sink function.
+ * \param index Index of input segments.
+ * \param probes Probe segments.
+ * \param sink Intersection sink.
+ * \param pool Thread pool.
+ */
+template<class Sink>
+void answerProbes( SegmentIndex const &index, std::vector<Segment> const &probes, Sink &sink,
+                   ThreadPool &pool )
+{
+    index.probe(probes, sink, &pool);
+}
+
+/*!
+ * \brief Answer window queries function.
+ * \param index Index of input segments.
+ * \param windows Windows, opposite corners as segment ends.
+ * \param os Output stream.
+ */
+void answerWindows( SegmentIndex const &index, std::vector<Segment> const &windows, std::ostream &os )
+{
+    auto &segments = index.segments();
+    for (auto &w : windows)
+    {
+        Point p0 = w.p0(), p1 = w.p1();
+        index.window(p0.x, std::min(p0.y, p1.y), p1.x, std::max(p0.y, p1.y), [&]( uint32_t s )
+        {
+            os << w.id() << ' ' << segments[s].id() << '\n';
+        });
+    }
 }
 
 int main( int argc, char *argv[] )
 {
-    if (argc != 5 && argc != 3)
+    if (argc < 3)
     {
         help();
         return 0;
     }
 
-    std::string inputFileName, outputFileName;
+    std::string inputFileName, outputFileName, indexFileName, probeFileName, windowFileName;
     std::ostream *os = &std::cout;
     std::ofstream ofs;
-    for (int i = 1; i < argc; i += 2)
-        if (!strcmp(argv[i], "-i"))
-            inputFileName = argv[i + 1];
-        else if (!strcmp(argv[i], "-o"))
+    bool sorted = false, general = false, binaryOutput = false, printStats = false;
+    unsigned threads = 1;
+    Engine engine = Engine::SWEEP;
+    enum class Mode { LIST, COUNT, COUNT_PER_SEGMENT, INDEX, PROBES, WINDOWS } mode = Mode::LIST;
+    for (int i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "-i") && i + 1 < argc)
+            inputFileName = argv[++i];
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
         {
-            ofs = std::ofstream(argv[i + 1]);
+            ofs = std::ofstream(argv[++i], std::ios::binary);
 
             if (!ofs)
             {
-                std::clog << "file " << argv[i + 1] << " not found\n";
+                std::clog << "file " << argv[i] << " not found\n";
             }
             os = &ofs;
         }
+        else if (!strcmp(argv[i], "-s"))
+            sorted = true;
+        else if (!strcmp(argv[i], "-t") && i + 1 < argc)
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (!strcmp(argv[i], "-g"))
+            general = true;
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc && !strcmp(argv[i + 1], "sweep"))
+            engine = Engine::SWEEP, i++;
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc && !strcmp(argv[i + 1], "grid"))
+            engine = Engine::GRID, i++;
+        else if (!strcmp(argv[i], "-e") && i + 1 < argc && !strcmp(argv[i + 1], "auto"))
+            engine = Engine::AUTO, i++;
+        else if (!strcmp(argv[i], "-b"))
+            binaryOutput = true;
+        else if (!strcmp(argv[i], "-c"))
+            mode = Mode::COUNT;
+        else if (!strcmp(argv[i], "-C"))
+            mode = Mode::COUNT_PER_SEGMENT;
+        else if (!strcmp(argv[i], "-x") && i + 1 < argc)
+            indexFileName = argv[++i], mode = Mode::INDEX;
+        else if (!strcmp(argv[i], "-q") && i + 1 < argc)
+            probeFileName = argv[++i], mode = Mode::PROBES;
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc)
+            windowFileName = argv[++i], mode = Mode::WINDOWS;
+        else if (!strcmp(argv[i], "--stats"))
+            printStats = true;
         else
         {
             help();
-            break;
+            return 0;
         }
 
 
-    SegmentLoader loader;
+    // reports after output is flushed and pool is joined
+    Stats::Report report(printStats ? &std::clog : nullptr);
+    ThreadPool pool(threads);
+    if (mode == Mode::LIST)
+    {
+        if (binaryOutput)
+        {
+            BinarySink sink(*os);
+            listIntersections(inputFileName, sorted, general, engine, pool, sink);
+        }
+        else
+        {
+            TextSink sink(*os);
+            listIntersections(inputFileName, sorted, general, engine, pool, sink);
+        }
+        return 0;
+    }
 
+    if (mode == Mode::INDEX || mode == Mode::PROBES || mode == Mode::WINDOWS)
+    {
+        SegmentIndex index;
+        if (!loadIndex(inputFileName, index))
+        {
+            std::clog << "Something went wrong while loading input file\n";
+            return 0;
+        }
+        if (mode == Mode::INDEX)
+        {
+            if (!index.save(indexFileName))
+                std::clog << "Something went wrong while writing index file\n";
+            return 0;
+        }
+
+        bool ok;
+        auto queries = SegmentLoader::loadFromFile(mode == Mode::PROBES ? probeFileName : windowFileName, &ok);
+        if (!ok)
+        {
+            std::clog << "Something went wrong while loading query file\n";
+            return 0;
+        }
+        if (mode == Mode::WINDOWS)
+            answerWindows(index, queries, *os);
+        else if (binaryOutput)
+        {
+            BinarySink sink(*os);
+            answerProbes(index, queries, sink, pool);
+        }
+        else
+        {
+            TextSink sink(*os);
+            answerProbes(index, queries, sink, pool);
+        }
+        return 0;
+    }
+
+    SegmentLoader loader;
     bool ok;
     auto segments = loader.loadFromFile(inputFileName, &ok);
     if (!ok)
@@ -54,8 +275,17 @@ int main( int argc, char *argv[] )
         return 0;
     }
 
+    // counting needs all y in advance, input order does not matter
     Intersector intersector;
-    intersector.computeIntersections(segments, os);
+    std::vector<uint32_t> perSegment;
+    bool perSegmentNeeded = mode == Mode::COUNT_PER_SEGMENT;
+    uint64_t total = intersector.countIntersections(segments, perSegmentNeeded ? &perSegment : nullptr, &pool);
+
+    STATS_PHASE("output");
+    *os << total << '\n';
+    if (perSegmentNeeded)
+        for (size_t i = 0; i < segments.size(); i++)
+            *os << segments[i].id() << ' ' << perSegment[i] << '\n';
 
     return 0;
 }
@@ -1,7 +1,5 @@
-#include <cmath>
 #include "primitives.h"
-
-const float Segment::tolerance = 1e-5f;
+#include "predicates.h"
 
 Segment::Segment(const Point &p0, const Point &p1, int id) : _id(id)
 {
@@ -28,13 +26,14 @@ Segment::Segment(const Point &p0, const Point &p1, int id) : _id(id)
     }
 
     orient =
-            std::fabs(p0.x - p1.x) < tolerance ? Orientation::VERTICAL :
-            (std::fabs(p0.y - p1.y) < tolerance ? Orientation::HORIZONTAL :
-                                       Orientation::NONE);
+            p0.x == p1.x ? Orientation::VERTICAL :
+            (p0.y == p1.y ? Orientation::HORIZONTAL : Orientation::NONE);
 }
 
 Point Segment::intersect( Segment const &other, bool &has_intersect ) const
 {
+    if (orient == Orientation::NONE || other.orient == Orientation::NONE)
+        return intersect_general(other, has_intersect);
     if (orient == Orientation::HORIZONTAL &&
         other.orient == Orientation::HORIZONTAL)
         return intersect_hor_hor(other, has_intersect);
@@ -71,53 +70,20 @@ bool Segment::operator==(const Segment &rhs) const
 
 Point Segment::intersect_hor_hor( const Segment &other, bool &has_intersect ) const
 {
-    if (std::fabs(_p0.y - other._p0.y) > Segment::tolerance)
-    {
-        has_intersect = false;
-        return {};
-    }
-
-    if (_p1.x >= other._p0.x)
-    {
-        // any point on common part of collinear edges
-        has_intersect = true;
-        return _p1;
-    }
-    else if (other._p1.x >= _p0.x)
-    {
-        has_intersect = true;
-        return _p0;
-    }
-    else
-    {
-        has_intersect = false;
+    // common part of collinear edges starts at the later left end
+    has_intersect = _p0.y == other._p0.y && _p0.x <= other._p1.x && other._p0.x <= _p1.x;
+    if (!has_intersect)
         return {};
-    }
+    return _p0.x < other._p0.x ? other._p0 : _p0;
 }
 
 Point Segment::intersect_ver_ver(const Segment &other, bool &has_intersect) const
 {
-    if (std::fabs(_p0.x - other._p0.x) > Segment::tolerance)
-    {
-        has_intersect = false;
+    // common part of collinear edges starts at the later lower end
+    has_intersect = _p0.x == other._p0.x && _p0.y <= other._p1.y && other._p0.y <= _p1.y;
+    if (!has_intersect)
         return {};
-    }
-    if (_p1.y >= other._p0.y)
-    {
-        // any point on common part of collinear edges
-        has_intersect = true;
-        return _p1;
-    }
-    else if (other._p1.y >= _p0.y)
-    {
-        has_intersect = true;
-        return _p0;
-    }
-    else
-    {
-        has_intersect = false;
-        return {};
-    }
+    return _p0.y < other._p0.y ? other._p0 : _p0;
 }
 
 Point Segment::intersect_hor_ver(const Segment &other, bool &has_intersect) const
@@ -153,6 +119,57 @@ Point Segment::intersect_hor_ver(const Segment &other, bool &has_intersect) cons
     }
 }
 
+Point Segment::intersect_general( Segment const &other, bool &has_intersect ) const
+{
+    auto orient = []( Point const &a, Point const &b, Point const &c )
+    {
+        double det = Predicates::orient2d(a.x, a.y, b.x, b.y, c.x, c.y);
+        return det > 0 ? 1 : (det < 0 ? -1 : 0);
+    };
+    // exact lexicographic order, ends are sorted by it
+    auto less = []( Point const &a, Point const &b )
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    };
+
+    int
+            o1 = orient(_p0, _p1, other._p0),
+            o2 = orient(_p0, _p1, other._p1),
+            o3 = orient(other._p0, other._p1, _p0),
+            o4 = orient(other._p0, other._p1, _p1);
+    has_intersect = o1 * o2 <= 0 && o3 * o4 <= 0;
+    if (!has_intersect)
+        return {};
+
+    if (o1 == 0 && o2 == 0 && o3 == 0 && o4 == 0)
+    {
+        // collinear or degenerate: common part is between the later
+        // first end and the earlier second end
+        Point
+                start = less(_p0, other._p0) ? other._p0 : _p0,
+                finish = less(_p1, other._p1) ? _p1 : other._p1;
+        has_intersect = !less(finish, start);
+        return start;
+    }
+
+    // touching at end
+    if (o1 == 0)
+        return other._p0;
+    if (o2 == 0)
+        return other._p1;
+    if (o3 == 0)
+        return _p0;
+    if (o4 == 0)
+        return _p1;
+
+    double
+            dax = double(_p1.x) - _p0.x, day = double(_p1.y) - _p0.y,
+            dbx = double(other._p1.x) - other._p0.x, dby = double(other._p1.y) - other._p0.y,
+            t = ((other._p0.x - double(_p0.x)) * dby - (other._p0.y - double(_p0.y)) * dbx) /
+                (dax * dby - day * dbx);
+    return {roundToCoordinate(_p0.x + dax * t), roundToCoordinate(_p0.y + day * t)};
+}
+
 std::istream &operator>>(std::istream &is, Point &pt)
 {
     is >> pt.x >> pt.y;
@@ -176,23 +193,18 @@ std::istream &operator>>(std::istream &is, Segment &seg)
 
 Point::Point() {}
 
-Point::Point(float x, float y) : x(x), y(y)
+Point::Point(Coord x, Coord y) : x(x), y(y)
 {}
 
 bool Point::operator==(const Point &rhs) const
 {
-    return
-            (rhs.x - x) * (rhs.x - x) +
-            (rhs.y - y) * (rhs.y - y) < Segment::tolerance;
+    return x == rhs.x && y == rhs.y;
 }
 
 bool Point::operator<(const Point &rhs) const
 {
-    if (x + Segment::tolerance < rhs.x)
-        return true;
-    if (x > rhs.x + Segment::tolerance)
-        return false;
-    return y < rhs.y;
+    // exact lexicographic order: tolerance would break transitivity
+    return x < rhs.x || (x == rhs.x && y < rhs.y);
 }
 
 bool Point::operator<=(const Point &rhs) const
@@ -4,13 +4,14 @@
 #include <istream>
 #include <vector>
 #include <string>
+#include "coordinate.h"
 
 /*!
  * \brief The Point struct
  */
 struct Point
 {
-    float x, y;
+    Coord x, y;
 
     /*!
      * \brief Default class constructor.
@@ -22,10 +23,11 @@ struct Point
      * \param x x.
      * \param y y.
      */
-    Point( float x, float y );
+    Point( Coord x, Coord y );
 
     /*!
      * \brief Comparator function.
+     * \details Coordinates are compared exactly.
      * \param rhs Point to compare with.
      * \return true if equal, false otherwise.
      */
@@ -33,6 +35,7 @@ struct Point
 
     /*!
      * \brief Strict order operator.
+     * \details Exact lexicographic order by x, then y.
      * \param rhs Point to compare with.
      * \return True if less, false otherwise.
      */
@@ -58,6 +61,8 @@ public:
      * \details - vertical
      * \details - horizontal
      * \details - none
+     * \details Ends of vertical segment have exactly equal x, of horizontal
+     * \details one -- exactly equal y.
      */
     enum class Orientation
     {
@@ -66,8 +71,6 @@ public:
         NONE
     };
 
-    static const float tolerance;
-
     Segment() {}
 
     /*!
@@ -142,6 +145,16 @@ private:
      */
     Point intersect_hor_ver( Segment const &other, bool &has_intersect ) const;
 
+    /*!
+     * \brief Intersect segments of any orientation function.
+     * \details Uses exact orientation tests, so touching and collinear
+     * \details segments are detected reliably.
+     * \param other[IN] segment to intersect.
+     * \param has_intersect[OUT] true if has intersection, false otherwise.
+     * \return point of intersection, for overlapping segments any common point.
+     */
+    Point intersect_general( Segment const &other, bool &has_intersect ) const;
+
     //! Ends of segment
     Point _p0, _p1;
     //! Identifier
@@ -0,0 +1,102 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "thread_pool.h"
+
+/*!
+ * \brief Stable LSD radix sort by 64 bit key function.
+ * \details Sorts by bytes of key from lowest to highest, bytes equal in
+ * \details every key are skipped. Every pass splits records into chunks:
+ * \details chunk histograms and scatter run in parallel, chunk offsets
+ * \details are laid out in chunk order to keep sort stable.
+ * \param records[IN, OUT] Records to sort.
+ * \param keyOf Functor returning uint64_t key of record.
+ * \param pool Thread pool, may be null.
+ */
+template<class Record, class KeyOf>
+void radixSort( std::vector<Record> &records, KeyOf keyOf, ThreadPool *pool = nullptr )
+{
+    static const std::size_t minChunkSize = 1 << 16;
+    const std::size_t n = records.size();
+    if (n < 2)
+        return;
+
+    std::size_t chunks = pool ? std::max<std::size_t>(
+                                    1, std::min<std::size_t>(pool->size(), n / minChunkSize)) : 1;
+    auto forChunks = [&]( std::function<void( std::size_t )> const &task )
+    {
+        if (chunks > 1)
+            pool->run(chunks, task);
+        else
+            task(0);
+    };
+    auto chunkBegin = [&]( std::size_t c )
+    {
+        return n * c / chunks;
+    };
+
+    // bits that differ between keys
+    std::vector<uint64_t> chunkDiff(chunks, 0);
+    uint64_t first = keyOf(records[0]);
+    forChunks([&]( std::size_t c )
+    {
+        uint64_t diff = 0;
+        for (std::size_t i = chunkBegin(c), end = chunkBegin(c + 1); i < end; i++)
+            diff |= keyOf(records[i]) ^ first;
+        chunkDiff[c] = diff;
+    });
+    uint64_t diff = 0;
+    for (auto d : chunkDiff)
+        diff |= d;
+    if (diff == 0)
+        return;
+
+    std::vector<Record> buffer(n);
+    std::vector<Record> *src = &records, *dst = &buffer;
+    std::vector<std::size_t> offsets(chunks * 256);
+
+    for (unsigned shift = 0; shift < 64; shift += 8)
+    {
+        if (((diff >> shift) & 0xFF) == 0)
+            continue;
+
+        forChunks([&]( std::size_t c )
+        {
+            std::size_t *count = &offsets[c * 256];
+            std::fill(count, count + 256, 0);
+            for (std::size_t i = chunkBegin(c), end = chunkBegin(c + 1); i < end; i++)
+                count[(keyOf((*src)[i]) >> shift) & 0xFF]++;
+        });
+
+        // digit major, chunk minor
+        std::size_t sum = 0;
+        for (std::size_t digit = 0; digit < 256; digit++)
+            for (std::size_t c = 0; c < chunks; c++)
+            {
+                std::size_t count = offsets[c * 256 + digit];
+                offsets[c * 256 + digit] = sum;
+                sum += count;
+            }
+
+        forChunks([&]( std::size_t c )
+        {
+            std::size_t *offset = &offsets[c * 256];
+            for (std::size_t i = chunkBegin(c), end = chunkBegin(c + 1); i < end; i++)
+            {
+                auto &record = (*src)[i];
+                (*dst)[offset[(keyOf(record) >> shift) & 0xFF]++] = record;
+            }
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != &records)
+        records.swap(buffer);
+}
+
+#endif // RADIX_SORT_H
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cmath>
+#include "segment_generator.h"
+
+SegmentGenerator::SegmentGenerator( uint64_t seed, uint32_t range ) : engine(seed), range(range) {}
+
+std::vector<Segment> SegmentGenerator::uniform( std::size_t n )
+{
+    // mean length 2 range / sqrt(n): a horizontal and a vertical cross
+    // with probability about 4 / n, n^2 / 4 such pairs give n crossings
+    auto maxLength = static_cast<uint32_t>(
+                std::max(2.0, 4.0 * range / std::sqrt(static_cast<double>(std::max<std::size_t>(n, 1)))));
+
+    std::vector<Segment> segments;
+    segments.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        bool horizontal = i % 2 == 0;
+        uint32_t along = below(range), across = below(range + 1), length = 1 + below(maxLength);
+        segments.push_back(make(horizontal, along, across, length, static_cast<int>(i)));
+    }
+    return segments;
+}
+
+std::vector<Segment> SegmentGenerator::mesh( std::size_t n )
+{
+    auto lines = static_cast<uint32_t>(std::max(1.0, std::sqrt(static_cast<double>(n))));
+    uint32_t cell = std::max<uint32_t>(1, range / lines);
+
+    std::vector<Segment> segments;
+    segments.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        bool horizontal = i % 2 == 0;
+        uint32_t
+                along = below(lines) * cell,
+                across = below(lines + 1) * cell,
+                length = (1 + below(4)) * cell;
+        segments.push_back(make(horizontal, along, across, length, static_cast<int>(i)));
+    }
+    return segments;
+}
+
+std::vector<Segment> SegmentGenerator::longHorizontals( std::size_t n )
+{
+    // each vertical crosses about two horizontals
+    std::size_t horizontals = std::max<std::size_t>(1, n / 8);
+    auto length = static_cast<uint32_t>(
+                std::max(1.0, 2.0 * range / static_cast<double>(horizontals)));
+
+    std::vector<Segment> segments;
+    segments.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        int id = static_cast<int>(i);
+        if (i % 8 == 0)
+            segments.push_back(make(true, 0, below(range + 1), range, id));
+        else
+            segments.push_back(make(false, below(range), below(range + 1), length, id));
+    }
+    return segments;
+}
+
+double SegmentGenerator::real()
+{
+    // upper 53 bits of engine output
+    return static_cast<double>(engine() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+uint32_t SegmentGenerator::below( uint32_t bound )
+{
+    return static_cast<uint32_t>(real() * bound);
+}
+
+Segment SegmentGenerator::make( bool horizontal, uint32_t along, uint32_t across, uint32_t length,
+                                int id ) const
+{
+    Coord
+            a0 = static_cast<Coord>(along),
+            a1 = static_cast<Coord>(std::min<uint64_t>(range, uint64_t(along) + length)),
+            b = static_cast<Coord>(across);
+    if (horizontal)
+        return Segment(Point(a0, b), Point(a1, b), id);
+    return Segment(Point(b, a0), Point(b, a1), id);
+}
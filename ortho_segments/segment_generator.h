@@ -0,0 +1,86 @@
+#ifndef SEGMENT_GENERATOR_H
+#define SEGMENT_GENERATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "primitives.h"
+
+/*!
+ * \brief The SegmentGenerator class
+ * \details Seeded synthetic horizontal and vertical segments for
+ * \details benchmarks. Random numbers are made from raw 64 bit engine
+ * \details output, so a seed gives the same segments with any standard
+ * \details library. Coordinates are integers in [0, range], exact for
+ * \details both coordinate types while range is at most 2^24. Ids are
+ * \details 0..n-1 in list order.
+ */
+class SegmentGenerator
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param seed Random seed.
+     * \param range Coordinate range.
+     */
+    explicit SegmentGenerator( uint64_t seed, uint32_t range = 1 << 22 );
+
+    /*!
+     * \brief Uniform segments function.
+     * \details Half horizontals and half verticals at uniform positions,
+     * \details lengths are chosen to give about n crossings.
+     * \param n Number of segments.
+     * \return Segments.
+     */
+    std::vector<Segment> uniform( std::size_t n );
+
+    /*!
+     * \brief Grid mesh function.
+     * \details Segments lie on about sqrt(n) grid lines of each
+     * \details direction and span 1 to 4 cells, so ends are shared and
+     * \details collinear segments overlap.
+     * \param n Number of segments.
+     * \return Segments.
+     */
+    std::vector<Segment> mesh( std::size_t n );
+
+    /*!
+     * \brief Long horizontals function.
+     * \details One of eight segments is a horizontal spanning the whole
+     * \details range, the rest are short verticals crossing few of them:
+     * \details sweep status stays as large as it can be.
+     * \param n Number of segments.
+     * \return Segments.
+     */
+    std::vector<Segment> longHorizontals( std::size_t n );
+
+private:
+    /*!
+     * \brief Get uniform number in [0, 1) function.
+     */
+    double real();
+
+    /*!
+     * \brief Get uniform integer function.
+     * \param bound Upper bound.
+     * \return Integer in [0, bound).
+     */
+    uint32_t below( uint32_t bound );
+
+    /*!
+     * \brief Make segment function.
+     * \param horizontal Direction.
+     * \param along Coordinate of first end along direction.
+     * \param across Coordinate across direction.
+     * \param length Length, clipped to range.
+     * \param id Segment identifier.
+     * \return Segment.
+     */
+    Segment make( bool horizontal, uint32_t along, uint32_t across, uint32_t length, int id ) const;
+
+    std::mt19937_64 engine;
+    uint32_t range;
+};
+
+#endif // SEGMENT_GENERATOR_H
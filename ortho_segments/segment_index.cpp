@@ -0,0 +1,503 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "segment_index.h"
+#include "segment_loader.h"
+#include "mapped_file.h"
+#include "binary_format.h"
+#include "stats.h"
+
+const std::size_t SegmentIndex::probesPerTask = 1 << 12;
+
+namespace
+{
+
+/*!
+ * \brief Get tree height function.
+ * \param keyCount Number of distinct interval ends.
+ * \return log2 of number of leaves covering all slots.
+ */
+uint32_t treeHeight( std::size_t keyCount )
+{
+    std::size_t slots = keyCount ? 2 * keyCount - 1 : 1;
+    uint32_t height = 0;
+    while ((std::size_t(1) << height) < slots)
+        height++;
+    return height;
+}
+
+/*!
+ * \brief Pass every array of tree to visitor function.
+ * \details Order of arrays in index file.
+ */
+template<class Tree, class Visitor>
+void forEachArray( Tree &tree, Visitor &visit )
+{
+    visit(tree.keys);
+    visit(tree.itemStart);
+    visit(tree.itemValue);
+    visit(tree.itemSegment);
+    visit(tree.cascadeStart);
+    visit(tree.cascadeValue);
+    visit(tree.cascadeItem);
+    visit(tree.cascadeLeft);
+    visit(tree.cascadeRight);
+}
+
+/*!
+ * \brief The ArrayList struct
+ * \details Collects arrays to be written.
+ */
+struct ArrayList
+{
+    std::vector<void const *> data;
+    std::vector<uint64_t> counts;
+    std::vector<std::size_t> sizes;
+
+    template<class T>
+    void operator()( std::vector<T> const &array )
+    {
+        data.push_back(array.data());
+        counts.push_back(array.size());
+        sizes.push_back(sizeof(T));
+    }
+};
+
+/*!
+ * \brief The ArrayReader struct
+ * \details Reads arrays listed in table one after another.
+ */
+struct ArrayReader
+{
+    MappedFile const *file;
+    uint64_t const *counts;
+    std::size_t arrayCount, next, offset;
+    bool ok;
+
+    template<class T>
+    void operator()( std::vector<T> &array )
+    {
+        array.clear();
+        if (!ok || next >= arrayCount)
+        {
+            ok = false;
+            return;
+        }
+        uint64_t count = counts[next++];
+        offset = BinaryFormat::align(offset);
+        if (offset > file->size() || count > (file->size() - offset) / sizeof(T))
+        {
+            ok = false;
+            return;
+        }
+        array.resize(static_cast<std::size_t>(count));
+        std::memcpy(array.data(), file->data() + offset, array.size() * sizeof(T));
+        offset += array.size() * sizeof(T);
+    }
+};
+
+} // namespace
+
+void SegmentIndex::build( std::vector<Segment> const &segments )
+{
+    STATS_PHASE("index_build");
+    _segments = segments;
+
+    std::vector<Tree::Item> items[4];
+    for (uint32_t i = 0; i < segments.size(); i++)
+    {
+        Point p0 = segments[i].p0(), p1 = segments[i].p1();
+        switch (segments[i].orientation())
+        {
+        case Segment::Orientation::HORIZONTAL:
+            items[0].push_back(Tree::Item{p0.x, p1.x, p0.y, i});
+            items[2].push_back(Tree::Item{p0.x, p0.x, p0.y, i});
+            break;
+        case Segment::Orientation::VERTICAL:
+            items[1].push_back(Tree::Item{p0.y, p1.y, p0.x, i});
+            items[3].push_back(Tree::Item{p0.y, p0.y, p0.x, i});
+            break;
+        default:
+            break;
+        }
+    }
+
+    horizontals.build(std::move(items[0]), false);
+    verticals.build(std::move(items[1]), false);
+    horizontalStarts.build(std::move(items[2]), true);
+    verticalStarts.build(std::move(items[3]), true);
+}
+
+bool SegmentIndex::save( std::string const &fileName ) const
+{
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+
+    size_t n = _segments.size();
+    auto header = BinaryFormat::makeHeader(BinaryFormat::Type::SEGMENT_INDEX,
+                                           CoordinateTraits<Coord>::scalar(), n);
+    std::vector<int32_t> ids(n);
+    std::vector<Coord> coords[4];
+    for (auto &c : coords)
+        c.resize(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        auto &s = _segments[i];
+        ids[i] = s.id();
+        coords[0][i] = s.p0().x;
+        coords[1][i] = s.p0().y;
+        coords[2][i] = s.p1().x;
+        coords[3][i] = s.p1().y;
+
+        header.bbox[0] = std::min<double>(header.bbox[0], std::min(s.p0().x, s.p1().x));
+        header.bbox[1] = std::min<double>(header.bbox[1], std::min(s.p0().y, s.p1().y));
+        header.bbox[2] = std::max<double>(header.bbox[2], std::max(s.p0().x, s.p1().x));
+        header.bbox[3] = std::max<double>(header.bbox[3], std::max(s.p0().y, s.p1().y));
+    }
+
+    ArrayList arrays;
+    for (Tree const *tree : {&horizontals, &verticals, &horizontalStarts, &verticalStarts})
+        forEachArray(*tree, arrays);
+
+    BinaryFormat::Writer writer(ofs);
+
+    writer.put(&header, 0, sizeof(header));
+    writer.put(ids.data(), BinaryFormat::columnOffset(header, 0), n * sizeof(int32_t));
+    for (int c = 0; c < 4; c++)
+        writer.put(coords[c].data(), BinaryFormat::columnOffset(header, c + 1), n * sizeof(Coord));
+
+    size_t offset = BinaryFormat::align(BinaryFormat::fileSize(header));
+    writer.put(arrays.counts.data(), offset, arrays.counts.size() * sizeof(uint64_t));
+    for (size_t k = 0; k < arrays.data.size(); k++)
+        writer.put(arrays.data[k], BinaryFormat::align(writer.written()),
+            static_cast<size_t>(arrays.counts[k]) * arrays.sizes[k]);
+
+    return static_cast<bool>(ofs);
+}
+
+bool SegmentIndex::load( std::string const &fileName )
+{
+    STATS_PHASE("load");
+    MappedFile file;
+    if (!file.open(fileName))
+    {
+        std::clog << "file " << fileName << " not found\n";
+        return false;
+    }
+
+    // index arrays hold coordinates of build type, they are not converted
+    static const size_t arrayCount = 4 * 9;
+    BinaryFormat::Header header;
+    size_t tableOffset = 0;
+    bool ok = BinaryFormat::isBinary(file.data(), file.size());
+    if (ok)
+    {
+        std::memcpy(&header, file.data(), sizeof(header));
+        ok = header.version == BinaryFormat::version &&
+                header.type == BinaryFormat::Type::SEGMENT_INDEX &&
+                header.scalar == CoordinateTraits<Coord>::scalar() &&
+                BinaryFormat::fits(header, file.size());
+    }
+    if (ok)
+    {
+        tableOffset = BinaryFormat::align(BinaryFormat::fileSize(header));
+        ok = tableOffset <= file.size() &&
+                arrayCount <= (file.size() - tableOffset) / sizeof(uint64_t);
+    }
+    if (ok)
+        _segments = SegmentLoader::loadFromFile(fileName, &ok);
+    if (ok)
+    {
+        std::vector<uint64_t> counts(arrayCount);
+        std::memcpy(counts.data(), file.data() + tableOffset, arrayCount * sizeof(uint64_t));
+        ArrayReader reader{&file, counts.data(), arrayCount, 0,
+                           tableOffset + arrayCount * sizeof(uint64_t), true};
+        for (Tree *tree : {&horizontals, &verticals, &horizontalStarts, &verticalStarts})
+        {
+            forEachArray(*tree, reader);
+            ok = reader.ok && tree->restore(_segments.size());
+            if (!ok)
+                break;
+        }
+    }
+    if (!ok)
+    {
+        std::clog << "wrong file format\n";
+        *this = SegmentIndex();
+    }
+    return ok;
+}
+
+bool SegmentIndex::isIndexFile( std::string const &fileName )
+{
+    MappedFile file;
+    if (!file.open(fileName) || !BinaryFormat::isBinary(file.data(), file.size()))
+        return false;
+    BinaryFormat::Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    return header.type == BinaryFormat::Type::SEGMENT_INDEX;
+}
+
+std::vector<Segment> const & SegmentIndex::segments() const
+{
+    return _segments;
+}
+
+std::vector<uint32_t> SegmentIndex::probeOrder( std::vector<Segment> const &probes )
+{
+    std::vector<uint32_t> order;
+    for (uint32_t i = 0; i < probes.size(); i++)
+        if (probes[i].orientation() != Segment::Orientation::NONE)
+            order.push_back(i);
+
+    // line key is x of verticals and y of horizontals, then the other end
+    std::sort(order.begin(), order.end(), [&]( uint32_t lhs, uint32_t rhs )
+    {
+        Segment const &l = probes[lhs], &r = probes[rhs];
+        bool lv = l.orientation() == Segment::Orientation::VERTICAL,
+                rv = r.orientation() == Segment::Orientation::VERTICAL;
+        if (lv != rv)
+            return lv;
+        Coord
+                lk = lv ? l.p0().x : l.p0().y, rk = rv ? r.p0().x : r.p0().y,
+                ls = lv ? l.p0().y : l.p0().x, rs = rv ? r.p0().y : r.p0().x;
+        if (lk != rk)
+            return lk < rk;
+        if (ls != rs)
+            return ls < rs;
+        return lhs < rhs;
+    });
+    return order;
+}
+
+void SegmentIndex::Tree::build( std::vector<Item> items, bool range )
+{
+    keys.clear();
+    for (auto &item : items)
+    {
+        keys.push_back(item.lo);
+        keys.push_back(item.hi);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    height = treeHeight(keys.size());
+
+    itemStart.clear();
+    itemValue.clear();
+    itemSegment.clear();
+    cascadeStart.clear();
+    cascadeValue.clear();
+    cascadeItem.clear();
+    cascadeLeft.clear();
+    cascadeRight.clear();
+    if (items.empty())
+        return;
+
+    // lists are filled in value order, ties in segment order
+    std::stable_sort(items.begin(), items.end(), []( Item const &lhs, Item const &rhs )
+    {
+        return lhs.value < rhs.value;
+    });
+
+    size_t leaves = size_t(1) << height, nodes = 2 * leaves;
+    std::vector<size_t> itemNodes;
+    auto collect = [&]( Item const &item )
+    {
+        // item ends are keys, so both slots exist
+        size_t first = 0, last = 0;
+        bool found = slot(item.lo, first) && slot(item.hi, last);
+        assert(found);
+        (void)found;
+        itemNodes.clear();
+        if (range)
+            for (size_t node = leaves + first; node > 0; node >>= 1)
+                itemNodes.push_back(node);
+        else
+            for (size_t l = leaves + first, r = leaves + last + 1; l < r; l >>= 1, r >>= 1)
+            {
+                if (l & 1)
+                    itemNodes.push_back(l++);
+                if (r & 1)
+                    itemNodes.push_back(--r);
+            }
+    };
+
+    itemStart.assign(nodes + 1, 0);
+    for (auto &item : items)
+    {
+        collect(item);
+        for (size_t node : itemNodes)
+            itemStart[node + 1]++;
+    }
+    for (size_t node = 0; node < nodes; node++)
+        itemStart[node + 1] += itemStart[node];
+
+    std::vector<uint64_t> fill(itemStart.begin(), itemStart.end() - 1);
+    itemValue.resize(itemStart.back());
+    itemSegment.resize(itemStart.back());
+    for (auto &item : items)
+    {
+        collect(item);
+        for (size_t node : itemNodes)
+        {
+            itemValue[fill[node]] = item.value;
+            itemSegment[fill[node]++] = item.segment;
+        }
+    }
+
+    // range tree children hold no entries the node does not, nothing to sample
+    std::vector<uint64_t> length(nodes, 0);
+    for (size_t node = nodes - 1; node > 0; node--)
+    {
+        length[node] = itemStart[node + 1] - itemStart[node];
+        if (!range && node < leaves)
+            length[node] += length[2 * node] / 4 + length[2 * node + 1] / 4;
+    }
+    cascadeStart.assign(nodes + 1, 0);
+    for (size_t node = 0; node < nodes; node++)
+        cascadeStart[node + 1] = cascadeStart[node] + length[node] + 1;
+    cascadeValue.resize(cascadeStart.back());
+    cascadeItem.resize(cascadeStart.back());
+    cascadeLeft.assign(cascadeStart.back(), 0);
+    cascadeRight.assign(cascadeStart.back(), 0);
+
+    // children go after parents, so they are built first
+    struct Entry
+    {
+        Coord value;
+        bool item;
+    };
+    auto less = []( Entry const &lhs, Entry const &rhs ) { return lhs.value < rhs.value; };
+    std::vector<Entry> own, left, right, samples, merged;
+    for (size_t node = nodes - 1; node > 0; node--)
+    {
+        own.clear();
+        for (uint64_t i = itemStart[node]; i < itemStart[node + 1]; i++)
+            own.push_back(Entry{itemValue[i], true});
+
+        left.clear();
+        right.clear();
+        if (!range && node < leaves)
+        {
+            for (uint64_t q = 3; q < length[2 * node]; q += 4)
+                left.push_back(Entry{cascadeValue[cascadeStart[2 * node] + q], false});
+            for (uint64_t q = 3; q < length[2 * node + 1]; q += 4)
+                right.push_back(Entry{cascadeValue[cascadeStart[2 * node + 1] + q], false});
+        }
+        samples.clear();
+        std::merge(left.begin(), left.end(), right.begin(), right.end(),
+                   std::back_inserter(samples), less);
+        merged.clear();
+        std::merge(own.begin(), own.end(), samples.begin(), samples.end(),
+                   std::back_inserter(merged), less);
+
+        uint64_t base = cascadeStart[node];
+        uint32_t count = 0;
+        for (size_t p = 0; p < merged.size(); p++)
+        {
+            cascadeValue[base + p] = merged[p].value;
+            cascadeItem[base + p] = count;
+            count += merged[p].item;
+        }
+        cascadeValue[base + merged.size()] = merged.empty() ? Coord() : merged.back().value;
+        cascadeItem[base + merged.size()] = count;
+
+        if (node >= leaves)
+            continue;
+        for (size_t child = 2 * node; child <= 2 * node + 1; child++)
+        {
+            auto &bridge = child & 1 ? cascadeRight : cascadeLeft;
+            Coord const *childValue = cascadeValue.data() + cascadeStart[child];
+            uint32_t q = 0, childLength = static_cast<uint32_t>(length[child]);
+            for (size_t p = 0; p < merged.size(); p++)
+            {
+                while (q < childLength && childValue[q] < merged[p].value)
+                    q++;
+                bridge[base + p] = q;
+            }
+            bridge[base + merged.size()] = childLength;
+        }
+    }
+}
+
+bool SegmentIndex::Tree::restore( std::size_t segmentCount )
+{
+    for (size_t k = 1; k < keys.size(); k++)
+        if (!(keys[k - 1] < keys[k]))
+            return false;
+    height = treeHeight(keys.size());
+
+    if (keys.empty())
+        return itemStart.empty() && itemValue.empty() && itemSegment.empty() &&
+                cascadeStart.empty() && cascadeValue.empty() && cascadeItem.empty() &&
+                cascadeLeft.empty() && cascadeRight.empty();
+
+    size_t leaves = size_t(1) << height, nodes = 2 * leaves;
+    if (itemStart.size() != nodes + 1 || cascadeStart.size() != nodes + 1 ||
+        itemStart.front() != 0 || cascadeStart.front() != 0 ||
+        itemStart.back() != itemValue.size() || itemStart.back() != itemSegment.size() ||
+        cascadeStart.back() != cascadeValue.size() || cascadeStart.back() != cascadeItem.size() ||
+        cascadeStart.back() != cascadeLeft.size() || cascadeStart.back() != cascadeRight.size())
+        return false;
+
+    for (uint32_t segment : itemSegment)
+        if (segment >= segmentCount)
+            return false;
+
+    auto cascadeLength = [&]( size_t node ) { return cascadeStart[node + 1] - cascadeStart[node]; };
+    for (size_t node = 0; node < nodes; node++)
+        if (itemStart[node + 1] < itemStart[node] || cascadeStart[node + 1] <= cascadeStart[node])
+            return false;
+    for (size_t node = 1; node < nodes; node++)
+        for (uint64_t e = cascadeStart[node]; e < cascadeStart[node + 1]; e++)
+        {
+            if (cascadeItem[e] > itemStart[node + 1] - itemStart[node])
+                return false;
+            if (node < leaves &&
+                (cascadeLeft[e] >= cascadeLength(2 * node) ||
+                 cascadeRight[e] >= cascadeLength(2 * node + 1)))
+                return false;
+        }
+    return true;
+}
+
+bool SegmentIndex::Tree::slot( Coord key, std::size_t &slot ) const
+{
+    size_t i = static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+    if (i < keys.size() && keys[i] == key)
+    {
+        slot = 2 * i;
+        return true;
+    }
+    // open gap between keys i - 1 and i
+    if (i == 0 || i == keys.size())
+        return false;
+    slot = 2 * i - 1;
+    return true;
+}
+
+uint32_t SegmentIndex::Tree::rootPosition( Coord value ) const
+{
+    auto
+            first = cascadeValue.begin() + static_cast<std::ptrdiff_t>(cascadeStart[1]),
+            last = cascadeValue.begin() + static_cast<std::ptrdiff_t>(cascadeStart[2] - 1);
+    return static_cast<uint32_t>(std::lower_bound(first, last, value) - first);
+}
+
+uint32_t SegmentIndex::Tree::descend( std::size_t node, uint32_t position, std::size_t child,
+                                      Coord value ) const
+{
+    // bridge is lower bound of the cascade entry value; sampled child
+    // entries are all in the node, so less than 4 child entries lie between
+    uint32_t q = (child & 1 ? cascadeRight : cascadeLeft)[cascadeStart[node] + position];
+    Coord const *childValue = cascadeValue.data() + cascadeStart[child];
+    while (q > 0 && !(childValue[q - 1] < value))
+        q--;
+    return q;
+}
@@ -0,0 +1,375 @@
+#ifndef SEGMENT_INDEX_H
+#define SEGMENT_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "primitives.h"
+#include "intersection_sink.h"
+#include "thread_pool.h"
+
+/*!
+ * \brief The SegmentIndex class
+ * \details Static index over horizontal and vertical segments for many
+ * \details queries against the same set: segments crossing a probe segment
+ * \details and segments meeting a window, O(log n + k) per query.
+ * \details Horizontals are kept in a segment tree over x with y sorted lists
+ * \details and verticals in one over y with x sorted lists; window queries
+ * \details use range trees over left (lower) ends as well. Lists of a path
+ * \details are searched by fractional cascading: one binary search at the
+ * \details root, constant work per level below. Memory is O(n log n).
+ * \details Index is saved to and loaded from binary file, see save().
+ * \details Queries do not modify index and may run concurrently.
+ */
+class SegmentIndex
+{
+public:
+    /*!
+     * \brief Build index function.
+     * \details Segments of other directions are kept but never reported.
+     * \param segments Segment list.
+     */
+    void build( std::vector<Segment> const &segments );
+
+    /*!
+     * \brief Save index to file function.
+     * \details BinaryFormat file of SEGMENT_INDEX type: segment columns as
+     * \details in segment file, then table of index array sizes and the
+     * \details arrays, every one aligned as columns are.
+     * \param fileName File name to write to.
+     * \return true if ok, false otherwise.
+     */
+    bool save( std::string const &fileName ) const;
+
+    /*!
+     * \brief Load index from file function.
+     * \param fileName File name to load from.
+     * \return true if ok, false otherwise.
+     */
+    bool load( std::string const &fileName );
+
+    /*!
+     * \brief Check if file holds an index function.
+     * \param fileName File name to check.
+     * \return true if file is saved index, false otherwise.
+     */
+    static bool isIndexFile( std::string const &fileName );
+
+    /*!
+     * \brief Get indexed segments function.
+     * \return Segment list, query results are indices in it.
+     */
+    std::vector<Segment> const & segments() const;
+
+    /*!
+     * \brief Find segments crossing probe function.
+     * \details Vertical probe gets horizontals crossing it, horizontal one
+     * \details gets verticals, the same points the sweep reports. Collinear
+     * \details segments having common points with probe follow as overlaps.
+     * \details id1 is always probe id, id2 is indexed segment id. Probes of
+     * \details other directions get nothing.
+     * \param probe Probe segment.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     */
+    template<class Sink>
+    void probe( Segment const &probe, Sink &sink ) const;
+
+    /*!
+     * \brief Find segments crossing every probe function.
+     * \details Probes are answered in order of their lines (verticals by x,
+     * \details then horizontals by y), so consecutive probes walk mostly the
+     * \details same tree nodes. Sorted probes are cut into tasks of fixed
+     * \details size and results are passed to sink in task order: output
+     * \details is the same for any number of threads.
+     * \param probes Probe segments.
+     * \param sink Sink receiving intersections, see intersection_sink.h.
+     * \param pool Thread pool to run tasks, may be null.
+     */
+    template<class Sink>
+    void probe( std::vector<Segment> const &probes, Sink &sink, ThreadPool *pool = nullptr ) const;
+
+    /*!
+     * \brief Find segments meeting window function.
+     * \details Horizontals and verticals having a point in closed window,
+     * \details every one is visited once.
+     * \param x0 Left side.
+     * \param y0 Bottom side.
+     * \param x1 Right side, not less than x0.
+     * \param y1 Top side, not less than y0.
+     * \param visit Callback taking segment index.
+     */
+    template<class Visitor>
+    void window( Coord x0, Coord y0, Coord x1, Coord y1, Visitor visit ) const;
+
+private:
+    /*!
+     * \brief Sort probes by line function.
+     * \param probes Probe segments.
+     * \return Indices of horizontal and vertical probes in answer order.
+     */
+    static std::vector<uint32_t> probeOrder( std::vector<Segment> const &probes );
+
+    //! Probes per task of batched query
+    static const std::size_t probesPerTask;
+
+    /*!
+     * \brief The Tree struct
+     * \details Segment tree over key intervals holding value sorted lists
+     * \details of segment indices. Leaves are slots: distinct interval ends
+     * \details and open gaps between them. Every node also has cascade list:
+     * \details its values merged with every 4th entry of cascade lists of
+     * \details children (all of them are in the node in range trees). Cascade
+     * \details entry holds the number of list entries before it and lower
+     * \details bound positions of its value in child cascade lists.
+     */
+    struct Tree
+    {
+        struct Item
+        {
+            Coord lo, hi, value;
+            uint32_t segment;
+        };
+
+        Tree() : height(0) {}
+
+        //! Distinct interval ends, ascending
+        std::vector<Coord> keys;
+        //! log2 of number of leaves
+        uint32_t height;
+        //! Node lists, by node (root is 1): start per node plus one
+        std::vector<uint64_t> itemStart;
+        std::vector<Coord> itemValue;
+        std::vector<uint32_t> itemSegment;
+        //! Cascade lists with end entry, by node: start per node plus one
+        std::vector<uint64_t> cascadeStart;
+        std::vector<Coord> cascadeValue;
+        std::vector<uint32_t> cascadeItem, cascadeLeft, cascadeRight;
+
+        /*!
+         * \brief Build tree function.
+         * \param items Intervals, values and segment indices.
+         * \param range Range tree: intervals are single keys and nodes
+         * \param range hold all items below, otherwise items are held by
+         * \param range canonical nodes of their intervals.
+         */
+        void build( std::vector<Item> items, bool range );
+
+        /*!
+         * \brief Check loaded tree function.
+         * \details Recomputes height and checks every list start and
+         * \details cascade position stays within arrays.
+         * \param segmentCount Number of segments.
+         * \return true if ok, false otherwise.
+         */
+        bool restore( std::size_t segmentCount );
+
+        /*!
+         * \brief Find leaf slot of key function.
+         * \param key Key.
+         * \param slot[OUT] Slot.
+         * \return false if key is outside of all intervals.
+         */
+        bool slot( Coord key, std::size_t &slot ) const;
+
+        /*!
+         * \brief Find cascade position of value at root function.
+         * \return Lower bound of value in root cascade list.
+         */
+        uint32_t rootPosition( Coord value ) const;
+
+        /*!
+         * \brief Follow cascade position to child function.
+         * \param node Node.
+         * \param position Lower bound of value in node cascade list.
+         * \param child Child of node.
+         * \param value Value.
+         * \return Lower bound of value in child cascade list.
+         */
+        uint32_t descend( std::size_t node, uint32_t position, std::size_t child, Coord value ) const;
+
+        /*!
+         * \brief Visit node list entries from cascade position function.
+         * \param node Node.
+         * \param position Lower bound of lower value in node cascade list.
+         * \param hi Upper value (inclusive).
+         * \param visit Callback taking segment index.
+         */
+        template<class Visitor>
+        void report( std::size_t node, uint32_t position, Coord hi, Visitor &visit ) const
+        {
+            uint64_t
+                    i = itemStart[node] + cascadeItem[cascadeStart[node] + position],
+                    end = itemStart[node + 1];
+            for (; i < end && itemValue[i] <= hi; i++)
+                visit(itemSegment[i]);
+        }
+
+        /*!
+         * \brief Visit items with interval containing key function.
+         * \param key Key.
+         * \param lo Lower value (inclusive).
+         * \param hi Upper value (inclusive).
+         * \param visit Callback taking segment index.
+         */
+        template<class Visitor>
+        void stab( Coord key, Coord lo, Coord hi, Visitor &visit ) const
+        {
+            std::size_t leaf;
+            if (hi < lo || !slot(key, leaf))
+                return;
+            leaf += std::size_t(1) << height;
+
+            std::size_t node = 1;
+            uint32_t position = rootPosition(lo);
+            for (uint32_t level = height; ; level--)
+            {
+                report(node, position, hi, visit);
+                if (level == 0)
+                    break;
+                std::size_t child = leaf >> (level - 1);
+                position = descend(node, position, child, lo);
+                node = child;
+            }
+        }
+
+        /*!
+         * \brief Visit items with key in half open range function.
+         * \details For range trees only.
+         * \param after Range start (exclusive).
+         * \param last Range end (inclusive).
+         * \param lo Lower value (inclusive).
+         * \param hi Upper value (inclusive).
+         * \param visit Callback taking segment index.
+         */
+        template<class Visitor>
+        void range( Coord after, Coord last, Coord lo, Coord hi, Visitor &visit ) const
+        {
+            if (hi < lo || keys.empty())
+                return;
+            // items sit at slots of keys, 2 * rank
+            std::size_t
+                    first = static_cast<std::size_t>(
+                        std::upper_bound(keys.begin(), keys.end(), after) - keys.begin()),
+                    end = static_cast<std::size_t>(
+                        std::upper_bound(keys.begin(), keys.end(), last) - keys.begin());
+            if (first >= end)
+                return;
+            rangeNode(1, 0, (std::size_t(1) << height) - 1, 2 * first, 2 * (end - 1),
+                      rootPosition(lo), lo, hi, visit);
+        }
+
+        /*!
+         * \brief Visit canonical nodes of slot range below node function.
+         */
+        template<class Visitor>
+        void rangeNode( std::size_t node, std::size_t nodeFirst, std::size_t nodeLast,
+                        std::size_t first, std::size_t last, uint32_t position,
+                        Coord lo, Coord hi, Visitor &visit ) const
+        {
+            if (first <= nodeFirst && nodeLast <= last)
+            {
+                report(node, position, hi, visit);
+                return;
+            }
+            std::size_t middle = nodeFirst + (nodeLast - nodeFirst) / 2;
+            if (first <= middle)
+                rangeNode(2 * node, nodeFirst, middle, first, last,
+                          descend(node, position, 2 * node, lo), lo, hi, visit);
+            if (last > middle)
+                rangeNode(2 * node + 1, middle + 1, nodeLast, first, last,
+                          descend(node, position, 2 * node + 1, lo), lo, hi, visit);
+        }
+    };
+
+    std::vector<Segment> _segments;
+    //! Horizontals by x interval with y lists, verticals by y interval with x lists
+    Tree horizontals, verticals;
+    //! Range trees of horizontals by left end x, verticals by lower end y
+    Tree horizontalStarts, verticalStarts;
+};
+
+template<class Sink>
+void SegmentIndex::probe( Segment const &probe, Sink &sink ) const
+{
+    Point p0 = probe.p0(), p1 = probe.p1();
+    switch (probe.orientation())
+    {
+    case Segment::Orientation::VERTICAL:
+    {
+        auto visit = [&]( uint32_t h )
+        {
+            sink(Intersection{probe.id(), _segments[h].id(), Point(p0.x, _segments[h].p0().y)});
+        };
+        horizontals.stab(p0.x, p0.y, p1.y, visit);
+
+        auto overlap = [&]( uint32_t v )
+        {
+            Segment const &s = _segments[v];
+            sink(Intersection{probe.id(), s.id(), Point(p0.x, std::max(p0.y, s.p0().y)),
+                              Point(p0.x, std::min(p1.y, s.p1().y))});
+        };
+        verticals.stab(p0.y, p0.x, p0.x, overlap);
+        verticalStarts.range(p0.y, p1.y, p0.x, p0.x, overlap);
+        break;
+    }
+    case Segment::Orientation::HORIZONTAL:
+    {
+        auto visit = [&]( uint32_t v )
+        {
+            sink(Intersection{probe.id(), _segments[v].id(), Point(_segments[v].p0().x, p0.y)});
+        };
+        verticals.stab(p0.y, p0.x, p1.x, visit);
+
+        auto overlap = [&]( uint32_t h )
+        {
+            Segment const &s = _segments[h];
+            sink(Intersection{probe.id(), s.id(), Point(std::max(p0.x, s.p0().x), p0.y),
+                              Point(std::min(p1.x, s.p1().x), p0.y)});
+        };
+        horizontals.stab(p0.x, p0.y, p0.y, overlap);
+        horizontalStarts.range(p0.x, p1.x, p0.y, p0.y, overlap);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+template<class Sink>
+void SegmentIndex::probe( std::vector<Segment> const &probes, Sink &sink, ThreadPool *pool ) const
+{
+    std::vector<uint32_t> order = probeOrder(probes);
+    std::size_t tasks = (order.size() + probesPerTask - 1) / probesPerTask;
+    if (!pool || pool->size() < 2 || tasks < 2)
+    {
+        for (uint32_t i : order)
+            probe(probes[i], sink);
+        return;
+    }
+
+    std::vector<std::vector<Intersection>> parts(tasks);
+    pool->run(tasks, [&]( std::size_t task )
+    {
+        VectorSink part(parts[task]);
+        std::size_t end = std::min(order.size(), (task + 1) * probesPerTask);
+        for (std::size_t k = task * probesPerTask; k < end; k++)
+            probe(probes[order[k]], part);
+    });
+    for (auto &part : parts)
+        for (auto &inter : part)
+            sink(inter);
+}
+
+template<class Visitor>
+void SegmentIndex::window( Coord x0, Coord y0, Coord x1, Coord y1, Visitor visit ) const
+{
+    // x interval meets [x0, x1] iff it contains x0 or starts in (x0, x1]
+    horizontals.stab(x0, y0, y1, visit);
+    horizontalStarts.range(x0, x1, y0, y1, visit);
+    verticals.stab(y0, x0, x1, visit);
+    verticalStarts.range(y0, y1, x0, x1, visit);
+}
+
+#endif // SEGMENT_INDEX_H
@@ -1,12 +1,36 @@
+#include <cstring>
 #include <fstream>
 #include <iostream>
 
 #include "segment_loader.h"
 #include "primitives.h"
 #include "intersector.h"
+#include "mapped_file.h"
+#include "binary_format.h"
+#include "stats.h"
+
+namespace
+{
+
+//! Segment ends have no reserved coordinates
+bool isAllowedSegment( Segment const &seg )
+{
+    return isAllowedCoordinate(seg.p0().x) && isAllowedCoordinate(seg.p0().y) &&
+            isAllowedCoordinate(seg.p1().x) && isAllowedCoordinate(seg.p1().y);
+}
+
+} // namespace
 
 std::vector<Segment> SegmentLoader::loadFromFile(const std::string &fileName, bool *ok)
 {
+    STATS_PHASE("load");
+
+    {
+        MappedFile file;
+        if (file.open(fileName) && BinaryFormat::isBinary(file.data(), file.size()))
+            return loadBinary(file, ok);
+    }
+
     std::ifstream ifs(fileName);
 
     if (!ifs)
@@ -25,7 +49,8 @@ std::vector<Segment> SegmentLoader::loadFromFile(const std::string &fileName, bo
 
         if (!(ifs >> seg))
         {
-            if (ifs.peek() != EOF)
+            // failed stream peeks EOF, so only trailing blanks may end at EOF
+            if (!ifs.eof())
             {
                 std::clog << "wrong file format\n";
                 if (ok)
@@ -33,9 +58,75 @@ std::vector<Segment> SegmentLoader::loadFromFile(const std::string &fileName, bo
                 return segments;
             }
         }
+        else if (!isAllowedSegment(seg))
+        {
+            std::clog << "reserved coordinate value in segment " << seg.id() << "\n";
+            if (ok)
+                *ok = false;
+            return segments;
+        }
         else
             segments.emplace_back(seg);
     }
-    *ok = true;
+    if (ok)
+        *ok = true;
+    return segments;
+}
+
+bool SegmentLoader::isBinaryFile( std::string const& fileName )
+{
+    MappedFile file;
+    return file.open(fileName) && BinaryFormat::isBinary(file.data(), file.size());
+}
+
+std::vector<Segment> SegmentLoader::loadBinary( MappedFile const &file, bool *ok )
+{
+    BinaryFormat::Header header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (header.version != BinaryFormat::version ||
+        (header.type != BinaryFormat::Type::SEGMENTS &&
+         header.type != BinaryFormat::Type::SEGMENT_INDEX) ||
+        BinaryFormat::scalarSize(header.scalar) == 0 ||
+        !isCoordinateScalar(header.scalar) ||
+        !BinaryFormat::fits(header, file.size()))
+    {
+        std::clog << "wrong file format\n";
+        if (ok)
+            *ok = false;
+        return {};
+    }
+
+    size_t n = static_cast<size_t>(header.count);
+    std::vector<int32_t> ids(n);
+    std::vector<Coord> coords[4];
+
+    std::memcpy(ids.data(), file.data() + BinaryFormat::columnOffset(header, 0),
+                n * sizeof(int32_t));
+    for (int c = 0; c < 4; c++)
+    {
+        coords[c].resize(n);
+        BinaryFormat::readColumn(file.data() + BinaryFormat::columnOffset(header, c + 1),
+                                 header.scalar, coords[c].data(), n);
+    }
+
+    std::vector<Segment> segments;
+    segments.reserve(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        segments.emplace_back(Point(coords[0][i], coords[1][i]),
+                              Point(coords[2][i], coords[3][i]), ids[i]);
+        if (!isAllowedSegment(segments.back()))
+        {
+            std::clog << "reserved coordinate value in segment " << ids[i] << "\n";
+            segments.pop_back();
+            if (ok)
+                *ok = false;
+            return segments;
+        }
+    }
+
+    if (ok)
+        *ok = true;
     return segments;
 }
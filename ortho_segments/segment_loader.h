@@ -7,17 +7,38 @@
 #include "intersector.h"
 
 class Segment;
+class MappedFile;
 
 class SegmentLoader
 {
 public:
     /*!
      * \brief Load segments from file function.
+     * \details Text files hold one "id x0 y0 x1 y1" record per line.
+     * \details Binary columnar files (see BinaryFormat) are detected by
+     * \details signature and read column by column without parsing.
+     * \details Saved segment index files (see SegmentIndex) are read as well.
      * \param fileName[IN] File name to load from.
      * \param ok[OUT] true if ok, false otherwise.
      * \return List of segments.
      */
     static std::vector<Segment> loadFromFile( std::string const& fileName, bool *ok=nullptr );
+
+    /*!
+     * \brief Check if file is in binary columnar format function.
+     * \param fileName[IN] File name to check.
+     * \return true if binary, false otherwise.
+     */
+    static bool isBinaryFile( std::string const& fileName );
+
+private:
+    /*!
+     * \brief Load segments from binary file function.
+     * \param file[IN] Mapped binary file.
+     * \param ok[OUT] true if ok, false otherwise.
+     * \return List of segments.
+     */
+    static std::vector<Segment> loadBinary( MappedFile const &file, bool *ok );
 };
 
 #endif // SEGMENT_LOADER_H
@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include "segment_writer.h"
+#include "binary_format.h"
+
+/*!
+ * \brief Format number to be read back exactly: %.7g, %.9g if it does not round-trip.
+ */
+static inline int formatExact( char *buf, size_t size, float value )
+{
+    int len = std::snprintf(buf, size, "%.7g", value);
+    if (std::strtof(buf, nullptr) != value)
+        len = std::snprintf(buf, size, "%.9g", value);
+    return len;
+}
+
+static inline int formatExact( char *buf, size_t size, int32_t value )
+{
+    return std::snprintf(buf, size, "%d", static_cast<int>(value));
+}
+
+bool SegmentWriter::saveText( std::string const &fileName, std::vector<Segment> const &segments )
+{
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+
+    std::vector<char> out;
+    out.reserve(1 << 20);
+    char buf[32];
+
+    for (auto &s : segments)
+    {
+        int len = std::snprintf(buf, sizeof(buf), "%d", s.id());
+        out.insert(out.end(), buf, buf + len);
+
+        Coord coords[4] = {s.p0().x, s.p0().y, s.p1().x, s.p1().y};
+        for (Coord c : coords)
+        {
+            out.push_back(' ');
+            len = formatExact(buf, sizeof(buf), c);
+            out.insert(out.end(), buf, buf + len);
+        }
+        out.push_back('\n');
+
+        if (out.size() >= (1 << 20))
+        {
+            ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+            out.clear();
+        }
+    }
+    ofs.write(out.data(), static_cast<std::streamsize>(out.size()));
+    return static_cast<bool>(ofs);
+}
+
+bool SegmentWriter::saveBinary( std::string const &fileName, std::vector<Segment> const &segments )
+{
+    std::ofstream ofs(fileName, std::ios::binary);
+    if (!ofs)
+        return false;
+
+    size_t n = segments.size();
+    auto header = BinaryFormat::makeHeader(BinaryFormat::Type::SEGMENTS,
+                                           CoordinateTraits<Coord>::scalar(), n);
+    std::vector<int32_t> ids(n);
+    std::vector<Coord> coords[4];
+    for (auto &c : coords)
+        c.resize(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        auto &s = segments[i];
+        ids[i] = s.id();
+        coords[0][i] = s.p0().x;
+        coords[1][i] = s.p0().y;
+        coords[2][i] = s.p1().x;
+        coords[3][i] = s.p1().y;
+
+        header.bbox[0] = std::min<double>(header.bbox[0], std::min(s.p0().x, s.p1().x));
+        header.bbox[1] = std::min<double>(header.bbox[1], std::min(s.p0().y, s.p1().y));
+        header.bbox[2] = std::max<double>(header.bbox[2], std::max(s.p0().x, s.p1().x));
+        header.bbox[3] = std::max<double>(header.bbox[3], std::max(s.p0().y, s.p1().y));
+    }
+
+    BinaryFormat::Writer writer(ofs);
+
+    writer.put(&header, 0, sizeof(header));
+    writer.put(ids.data(), BinaryFormat::columnOffset(header, 0), n * sizeof(int32_t));
+    for (int c = 0; c < 4; c++)
+        writer.put(coords[c].data(), BinaryFormat::columnOffset(header, c + 1), n * sizeof(Coord));
+
+    return static_cast<bool>(ofs);
+}
@@ -0,0 +1,31 @@
+#ifndef SEGMENT_WRITER_H
+#define SEGMENT_WRITER_H
+
+#include <vector>
+#include <string>
+
+#include "primitives.h"
+
+class SegmentWriter
+{
+public:
+    /*!
+     * \brief Save segments to text file function.
+     * \details One "id x0 y0 x1 y1" record per line. Real coordinates are
+     * \details printed with %.7g, or with %.9g if that does not read back exactly.
+     * \param fileName[IN] File name to write to.
+     * \param segments[IN] Segments to save.
+     * \return true if ok, false otherwise.
+     */
+    static bool saveText( std::string const &fileName, std::vector<Segment> const &segments );
+
+    /*!
+     * \brief Save segments to binary columnar file function.
+     * \param fileName[IN] File name to write to.
+     * \param segments[IN] Segments to save.
+     * \return true if ok, false otherwise.
+     */
+    static bool saveBinary( std::string const &fileName, std::vector<Segment> const &segments );
+};
+
+#endif // SEGMENT_WRITER_H
@@ -0,0 +1,160 @@
+#include "sweep_status.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static inline unsigned lowestBit( uint64_t word )
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, word);
+    return idx;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(word));
+#endif
+}
+
+void SlotBitset::resize( std::size_t n )
+{
+    bits = n;
+    levels.clear();
+    do
+    {
+        n = (n + 63) / 64;
+        levels.emplace_back(n, 0);
+    } while (n > 1);
+}
+
+void SlotBitset::set( std::size_t i )
+{
+    for (auto &level : levels)
+    {
+        uint64_t &word = level[i >> 6];
+        bool wasEmpty = word == 0;
+        word |= uint64_t(1) << (i & 63);
+        if (!wasEmpty)
+            break;
+        i >>= 6;
+    }
+}
+
+void SlotBitset::reset( std::size_t i )
+{
+    for (auto &level : levels)
+    {
+        uint64_t &word = level[i >> 6];
+        word &= ~(uint64_t(1) << (i & 63));
+        if (word != 0)
+            break;
+        i >>= 6;
+    }
+}
+
+std::size_t SlotBitset::next( std::size_t i ) const
+{
+    if (i >= bits)
+        return bits;
+
+    // climb until a word with set bit at or after position
+    std::size_t level = 0, pos = i;
+    while (true)
+    {
+        if (level == levels.size())
+            return bits;
+
+        std::size_t word = pos >> 6;
+        if (word < levels[level].size())
+        {
+            uint64_t rest = levels[level][word] & (~uint64_t(0) << (pos & 63));
+            if (rest != 0)
+            {
+                pos = (word << 6) | lowestBit(rest);
+                break;
+            }
+        }
+        pos = word + 1;
+        level++;
+    }
+
+    // descend to the leftmost set bit below
+    while (level > 0)
+    {
+        level--;
+        pos = (pos << 6) | lowestBit(levels[level][pos]);
+    }
+    return pos;
+}
+
+std::size_t SlotBitset::size() const
+{
+    return bits;
+}
+
+CompressedStatus::CompressedStatus( std::vector<Segment> const &segments ) :
+    slotOf(segments.size(), 0), count(0)
+{
+    for (uint32_t i = 0; i < segments.size(); i++)
+        if (segments[i].orientation() == Segment::Orientation::HORIZONTAL)
+            slotSegment.push_back(i);
+
+    std::sort(slotSegment.begin(), slotSegment.end(),
+              [&segments]( uint32_t lhs, uint32_t rhs )
+    {
+        Coord
+                lhs_y = segments[lhs].p0().y,
+                rhs_y = segments[rhs].p0().y;
+        return lhs_y < rhs_y || (lhs_y == rhs_y && lhs < rhs);
+    });
+
+    slotY.resize(slotSegment.size());
+    for (uint32_t s = 0; s < slotSegment.size(); s++)
+    {
+        slotY[s] = segments[slotSegment[s]].p0().y;
+        slotOf[slotSegment[s]] = s;
+    }
+    active.resize(slotSegment.size());
+}
+
+void CompressedStatus::insert( uint32_t segment )
+{
+    active.set(slotOf[segment]);
+    count++;
+}
+
+void CompressedStatus::erase( uint32_t segment )
+{
+    active.reset(slotOf[segment]);
+    count--;
+}
+
+std::size_t CompressedStatus::size() const
+{
+    return count;
+}
+
+FlatStatus::FlatStatus( std::vector<Segment> const &segments ) : segments(&segments) {}
+
+void FlatStatus::insert( uint32_t segment )
+{
+    Entry entry = {(*segments)[segment].p0().y, segment};
+    entries.insert(std::lower_bound(entries.begin(), entries.end(), entry), entry);
+}
+
+void FlatStatus::erase( uint32_t segment )
+{
+    Entry entry = {(*segments)[segment].p0().y, segment};
+    auto it = std::lower_bound(entries.begin(), entries.end(), entry);
+    if (it != entries.end() && it->segment == segment)
+        entries.erase(it);
+}
+
+std::size_t FlatStatus::size() const
+{
+    return entries.size();
+}
+
+void FlatStatus::clear()
+{
+    entries.clear();
+}
@@ -0,0 +1,188 @@
+#ifndef SWEEP_STATUS_H
+#define SWEEP_STATUS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include "primitives.h"
+
+/*!
+ * \brief The SlotBitset class
+ * \details Bitset with 64-ary summary levels on top: bit of a summary
+ * \details level is set iff the word below it is not zero. Finding next
+ * \details set bit costs O(log64 n) whatever gap is skipped.
+ */
+class SlotBitset
+{
+public:
+    /*!
+     * \brief Resize bitset function. All bits are cleared.
+     * \param n Number of bits.
+     */
+    void resize( std::size_t n );
+
+    /*!
+     * \brief Set bit function.
+     * \param i Bit number.
+     */
+    void set( std::size_t i );
+
+    /*!
+     * \brief Clear bit function.
+     * \param i Bit number.
+     */
+    void reset( std::size_t i );
+
+    /*!
+     * \brief Find next set bit function.
+     * \param i Bit number to start from.
+     * \return Number of first set bit not less than i, size() if none.
+     */
+    std::size_t next( std::size_t i ) const;
+
+    /*!
+     * \brief Get number of bits function.
+     * \return Number of bits.
+     */
+    std::size_t size() const;
+
+private:
+    std::size_t bits = 0;
+    //! levels[0] holds the bits themselves
+    std::vector<std::vector<uint64_t>> levels;
+};
+
+/*!
+ * \brief The CompressedStatus class
+ * \details Sweep status for a known set of horizontal segments.
+ * \details Horizontals are given fixed slots in (y, index) order, status
+ * \details is a bitset over slots: insert and erase flip one bit, range
+ * \details query scans slot arrays left to right. Segments with equal y
+ * \details get different slots and coexist.
+ */
+class CompressedStatus
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param segments Segments status indices refer to.
+     */
+    CompressedStatus( std::vector<Segment> const &segments );
+
+    /*!
+     * \brief Insert horizontal segment function.
+     * \param segment Segment index.
+     */
+    void insert( uint32_t segment );
+
+    /*!
+     * \brief Erase horizontal segment function.
+     * \param segment Segment index.
+     */
+    void erase( uint32_t segment );
+
+    /*!
+     * \brief Visit segments with y in range function.
+     * \param y0 Lower bound (inclusive).
+     * \param y1 Upper bound (inclusive).
+     * \param visit Callback taking segment index, called in (y, index) order.
+     */
+    template<class Visitor>
+    void forEach( Coord y0, Coord y1, Visitor visit ) const
+    {
+        std::size_t
+                lo = static_cast<std::size_t>(
+                    std::lower_bound(slotY.begin(), slotY.end(), y0) - slotY.begin()),
+                hi = static_cast<std::size_t>(
+                    std::upper_bound(slotY.begin(), slotY.end(), y1) - slotY.begin());
+        for (std::size_t s = active.next(lo); s < hi; s = active.next(s + 1))
+            visit(slotSegment[s]);
+    }
+
+    /*!
+     * \brief Get number of segments in status function.
+     * \return Number of segments.
+     */
+    std::size_t size() const;
+
+private:
+    //! y of slot, nondecreasing
+    std::vector<Coord> slotY;
+    //! Segment index of slot
+    std::vector<uint32_t> slotSegment;
+    //! Slot of segment by segment index
+    std::vector<uint32_t> slotOf;
+    SlotBitset active;
+    std::size_t count;
+};
+
+/*!
+ * \brief The FlatStatus class
+ * \details Sweep status as sorted array of (y, index) pairs, for segment
+ * \details sets that are not known in advance. Insert and erase shift the
+ * \details tail of array, range query scans contiguous entries.
+ */
+class FlatStatus
+{
+public:
+    /*!
+     * \brief Class constructor.
+     * \param segments Segments status indices refer to.
+     */
+    FlatStatus( std::vector<Segment> const &segments );
+
+    /*!
+     * \brief Insert horizontal segment function.
+     * \param segment Segment index.
+     */
+    void insert( uint32_t segment );
+
+    /*!
+     * \brief Erase horizontal segment function.
+     * \param segment Segment index.
+     */
+    void erase( uint32_t segment );
+
+    /*!
+     * \brief Visit segments with y in range function.
+     * \param y0 Lower bound (inclusive).
+     * \param y1 Upper bound (inclusive).
+     * \param visit Callback taking segment index, called in (y, index) order.
+     */
+    template<class Visitor>
+    void forEach( Coord y0, Coord y1, Visitor visit ) const
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), Entry{y0, 0});
+        for (; it != entries.end() && it->y <= y1; ++it)
+            visit(it->segment);
+    }
+
+    /*!
+     * \brief Get number of segments in status function.
+     * \return Number of segments.
+     */
+    std::size_t size() const;
+
+    /*!
+     * \brief Remove all segments function.
+     */
+    void clear();
+
+private:
+    struct Entry
+    {
+        Coord y;
+        uint32_t segment;
+
+        bool operator<( Entry const &rhs ) const
+        {
+            return y < rhs.y || (y == rhs.y && segment < rhs.segment);
+        }
+    };
+
+    std::vector<Segment> const *segments;
+    std::vector<Entry> entries;
+};
+
+#endif // SWEEP_STATUS_H